@@ -0,0 +1,72 @@
+# A compiler driver's options, parsed by both the generated and the
+# generic parser in cli_bench.
+namespace: bench_options
+
+option: output
+    short: -o
+    long: --output
+    argument: <file>
+    required: true
+    description: write the output to file
+
+option: include_directories
+    short: -I
+    long: --include-directory
+    argument: <directory>
+    multiple: true
+    description: add directory to the include search path
+
+option: definitions
+    short: -D
+    long: --define
+    argument: <macro>
+    multiple: true
+    description: define macro
+
+option: optimization
+    short: -O
+    long: --optimize
+    argument: <level>
+    default: 0
+    description: optimization level
+
+option: standard
+    long: --std
+    argument: <standard>
+    default: c++20
+    description: language standard
+
+option: jobs
+    short: -j
+    long: --jobs
+    argument: <count>
+    default: 1
+    description: number of parallel jobs
+
+option: compile_only
+    short: -c
+    long: --compile
+    description: compile without linking
+
+option: debug
+    short: -g
+    long: --debug
+    description: emit debug information
+
+option: verbose
+    short: -v
+    long: --verbose
+    description: print the commands run
+
+option: warnings_as_errors
+    long: --werror
+    description: treat warnings as errors
+
+option: pedantic
+    long: --pedantic
+    description: warn about non-standard extensions
+
+option: help
+    short: -h
+    long: --help
+    description: print this help
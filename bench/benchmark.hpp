@@ -0,0 +1,151 @@
+#pragma once
+
+#include <string_view>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <ostream>
+#include <string>
+#include <chrono>
+#include <vector>
+
+namespace cli::bench
+{
+    template<typename T>
+    inline void do_not_optimize(T&& value) noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "g"(&value) : "memory");
+#else
+	static volatile const void* sink;
+
+	sink = &value;
+#endif
+    }
+
+    struct result
+    {
+	std::string name;
+
+	std::size_t options    = 0;
+	std::size_t tokens     = 0;
+	std::size_t iterations = 0;
+
+	double median_ns = 0;
+	double min_ns    = 0;
+    };
+
+    class runner final
+    {
+    public:
+
+	using clock = std::chrono::steady_clock;
+
+	runner(std::string_view filter, std::chrono::nanoseconds batch_time) :
+	    filter_     {filter},
+	    batch_time_ {batch_time}
+	{}
+
+	bool enabled(std::string_view name) const noexcept
+	{
+	    return name.find(filter_) != std::string_view::npos;
+	}
+
+	// Runs the benchmark in batches sized to take at least batch_time
+	// each and records the per-iteration time of the median and
+	// fastest batch.
+	template<typename Function>
+	void run(std::string_view name,
+		 std::size_t options,
+		 std::size_t tokens,
+		 Function&& function)
+	{
+	    if (not enabled(name))
+	    {
+		return;
+	    }
+
+	    function();
+
+	    std::size_t iterations = 1;
+
+	    while (time(function, iterations) < batch_time_ &&
+		   iterations < (std::size_t {1} << 30))
+	    {
+		iterations *= 2;
+	    }
+
+	    std::vector<double> batches;
+
+	    for (int i = 0; i < batch_count; ++i)
+	    {
+		auto elapsed = time(function, iterations);
+
+		batches.emplace_back(
+		    static_cast<double>(elapsed.count()) / iterations);
+	    }
+
+	    std::sort(batches.begin(), batches.end());
+
+	    results_.emplace_back(result {
+		std::string {name},
+		options,
+		tokens,
+		iterations,
+		batches[batches.size() / 2],
+		batches.front()
+	    });
+	}
+
+	const std::vector<result>& results() const noexcept
+	{
+	    return results_;
+	}
+
+	void write_json(std::ostream& out) const
+	{
+	    out << "{\n  \"benchmarks\": [";
+
+	    for (std::size_t i = 0; i < results_.size(); ++i)
+	    {
+		auto& result = results_[i];
+
+		out << (i == 0 ? "\n" : ",\n")
+		    << "    {\"name\": \""       << result.name
+		    << "\", \"options\": "       << result.options
+		    << ", \"tokens\": "          << result.tokens
+		    << ", \"iterations\": "      << result.iterations
+		    << ", \"median_ns\": "       << result.median_ns
+		    << ", \"min_ns\": "          << result.min_ns
+		    << "}";
+	    }
+
+	    out << "\n  ]\n}\n";
+	}
+
+    private:
+
+	static constexpr int batch_count = 5;
+
+	template<typename Function>
+	static std::chrono::nanoseconds
+	time(Function& function, std::size_t iterations)
+	{
+	    auto start = clock::now();
+
+	    for (std::size_t i = 0; i < iterations; ++i)
+	    {
+		function();
+	    }
+
+	    return clock::now() - start;
+	}
+
+	std::string_view filter_;
+
+	std::chrono::nanoseconds batch_time_;
+
+	std::vector<result> results_;
+    };
+}
@@ -0,0 +1,576 @@
+#include <string_view>
+#include <filesystem>
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <cstddef>
+#include <utility>
+#include <string>
+#include <chrono>
+#include <vector>
+#include <deque>
+
+#include "core/shared_dictionary.hpp"
+#include "core/canonical_argv.hpp"
+#include "core/parse_cache.hpp"
+#include "core/dictionary.hpp"
+#include "core/grammar.hpp"
+#include "core/option_map.hpp"
+#include "core/option.hpp"
+#include "core/parser.hpp"
+
+#include "bench_options.hpp"
+#include "benchmark.hpp"
+
+using namespace cli::core;
+using namespace cli::bench;
+
+namespace
+{
+    // Options with even ids take arguments so they may repeat on the
+    // command line; the first 52 options also get a short name.
+    class synthetic_grammar final
+    {
+    public:
+
+	explicit synthetic_grammar(std::size_t size)
+	{
+	    std::vector<option> options;
+
+	    for (std::size_t i = 0; i < size; ++i)
+	    {
+		std::string_view short_name;
+
+		if (i < 52)
+		{
+		    char letter = i < 26 ? 'a' + i : 'A' + (i - 26);
+
+		    short_name = names.emplace_back(std::string {'-', letter});
+		}
+
+		auto& long_name =
+		    names.emplace_back("--option-" + std::to_string(i));
+
+		options.emplace_back(
+		    short_name,
+		    long_name,
+		    std::string_view {},
+		    std::string_view {},
+		    option::required::not_required,
+		    i % 2 == 0 ?
+			option::arguments::has_arguments :
+			option::arguments::no_arguments);
+	    }
+
+	    dictionary_ = dictionary {options.cbegin(), options.cend()};
+	}
+
+	const dictionary& get() const noexcept
+	{
+	    return dictionary_;
+	}
+
+	std::string_view long_name(std::size_t id) const noexcept
+	{
+	    return dictionary_.begin()[id].long_name();
+	}
+
+	std::size_t size() const noexcept
+	{
+	    return dictionary_.size();
+	}
+
+    private:
+
+	std::deque<std::string> names;
+
+	dictionary dictionary_;
+    };
+
+    // Every fourth option is written as --name=a,b,c, the rest as --name
+    // followed by a separate argument.
+    class synthetic_command_line final
+    {
+    public:
+
+	synthetic_command_line(const synthetic_grammar& grammar,
+			       std::size_t tokens)
+	{
+	    auto options = (grammar.size() + 1) / 2;
+
+	    for (std::size_t i = 0; storage.size() < tokens; ++i)
+	    {
+		std::string name {grammar.long_name(i % options * 2)};
+
+		if (i % 4 == 3 || storage.size() + 1 == tokens)
+		{
+		    storage.emplace_back(name + "=a,b,c");
+		}
+
+		else
+		{
+		    storage.emplace_back(name);
+		    storage.emplace_back("value-" + std::to_string(i));
+		}
+	    }
+
+	    argv_.emplace_back("");
+
+	    for (auto&& token : storage)
+	    {
+		argv_.emplace_back(token.c_str());
+	    }
+
+	    argv_.emplace_back(nullptr);
+	}
+
+	int argc() const noexcept
+	{
+	    return argv_.size() - 1;
+	}
+
+	const char** argv() noexcept
+	{
+	    return argv_.data();
+	}
+
+    private:
+
+	std::deque<std::string> storage;
+
+	std::vector<const char*> argv_;
+    };
+
+    const std::size_t grammar_sizes[] = {4, 10, 32, 100, 1'000, 10'000};
+    const std::size_t token_counts[]  = {10, 100, 10'000, 1'000'000};
+
+    constexpr std::size_t default_grammar_size = 100;
+    constexpr std::size_t default_token_count  = 1'000;
+
+    void bench_parse_command_line(runner& runner, std::size_t options,
+				  std::size_t tokens)
+    {
+	synthetic_grammar grammar {options};
+
+	synthetic_command_line command_line {grammar, tokens};
+
+	parser parser {grammar.get()};
+
+	runner.run("parser::parse_command_line", options, tokens, [&]
+	{
+	    parser.parse_command_line(command_line.argc(),
+				      command_line.argv());
+
+	    do_not_optimize(parser.options());
+	});
+    }
+
+    void bench_validate(runner& runner, std::size_t options, std::size_t tokens)
+    {
+	synthetic_grammar grammar {options};
+
+	synthetic_command_line command_line {grammar, tokens};
+
+	const parser parser {grammar.get()};
+
+	runner.run("parser::validate", options, tokens, [&]
+	{
+	    do_not_optimize(parser.validate(command_line.argc(),
+					    command_line.argv()));
+	});
+    }
+
+    void bench_parse_cache_hit(runner& runner, std::size_t options,
+			       std::size_t tokens)
+    {
+	synthetic_grammar grammar {options};
+
+	synthetic_command_line command_line {grammar, tokens};
+
+	parse_cache cache {{grammar.get()}, 1};
+
+	cache.parse(command_line.argc(), command_line.argv());
+
+	runner.run("parse_cache::parse (hit)", options, tokens, [&]
+	{
+	    do_not_optimize(cache.parse(command_line.argc(),
+					command_line.argv()));
+	});
+    }
+
+    void bench_add_command_line_options(runner& runner, std::size_t options,
+					std::size_t tokens)
+    {
+	synthetic_grammar grammar {options};
+
+	synthetic_command_line command_line {grammar, tokens};
+
+	parser parser {grammar.get()};
+
+	parser.parse_command_line(command_line.argc(), command_line.argv());
+
+	const option_map empty {grammar.get()};
+
+	runner.run("option_map::add_command_line_options", options, tokens, [&]
+	{
+	    option_map map {empty};
+
+	    map.add_command_line_options(parser.options());
+
+	    do_not_optimize(map);
+	});
+    }
+
+    void bench_option_map_lookup(runner& runner, std::size_t options)
+    {
+	synthetic_grammar grammar {options};
+
+	synthetic_command_line command_line {grammar, options};
+
+	parser parser {grammar.get()};
+
+	parser.parse_command_line(command_line.argc(), command_line.argv());
+
+	option_map map {grammar.get()};
+
+	map.add_command_line_options(parser.options());
+
+	std::vector<std::string_view> names;
+
+	for (std::size_t id = 0; id < grammar.size(); id += 2)
+	{
+	    names.emplace_back(grammar.long_name(id));
+	}
+
+	std::size_t next = 0;
+
+	runner.run("option_map::operator[]", options, options, [&]
+	{
+	    do_not_optimize(map[names[next]]);
+
+	    next = next + 1 == names.size() ? 0 : next + 1;
+	});
+    }
+
+    void bench_dictionary_contains(runner& runner, std::size_t options)
+    {
+	synthetic_grammar grammar {options};
+
+	std::vector<std::string_view> names;
+
+	for (std::size_t id = 0; id < grammar.size(); ++id)
+	{
+	    names.emplace_back(grammar.long_name(id));
+	}
+
+	names.emplace_back("--unknown");
+
+	std::size_t next = 0;
+
+	runner.run("dictionary::contains", options, 0, [&]
+	{
+	    auto contains = grammar.get().contains(names[next]);
+
+	    do_not_optimize(contains);
+
+	    next = next + 1 == names.size() ? 0 : next + 1;
+	});
+    }
+
+    void bench_grammar_find(runner& runner, std::size_t options)
+    {
+	synthetic_grammar synthetic {options};
+
+	std::vector<shared_dictionary> dictionaries {synthetic.get()};
+
+	std::vector<std::string_view> names;
+
+	for (std::size_t id = 0; id < synthetic.size(); ++id)
+	{
+	    names.emplace_back(synthetic.long_name(id));
+	}
+
+	names.emplace_back("--unknown");
+
+	const std::pair<std::string_view, grammar::lookup_strategy>
+	strategies[] = {
+	    {"grammar::find/automatic",     grammar::lookup_strategy::automatic},
+	    {"grammar::find/linear",        grammar::lookup_strategy::linear},
+	    {"grammar::find/binary_search", grammar::lookup_strategy::binary_search},
+	    {"grammar::find/hash",          grammar::lookup_strategy::hash},
+	    {"grammar::find/trie",          grammar::lookup_strategy::trie}
+	};
+
+	for (auto&& [name, strategy] : strategies)
+	{
+	    const grammar grammar {dictionaries, strategy};
+
+	    std::size_t next = 0;
+
+	    runner.run(name, options, 0, [&]
+	    {
+		do_not_optimize(grammar.find(names[next]));
+
+		next = next + 1 == names.size() ? 0 : next + 1;
+	    });
+	}
+    }
+
+    void bench_grammar_load(runner& runner, std::size_t options)
+    {
+	synthetic_grammar synthetic {options};
+
+	std::vector<shared_dictionary> dictionaries {synthetic.get()};
+
+	auto path = (std::filesystem::temp_directory_path() /
+		     ("cli_bench_grammar_" + std::to_string(options))).string();
+
+	grammar {dictionaries}.save(path.c_str());
+
+	runner.run("grammar::grammar (build)", options, 0, [&]
+	{
+	    do_not_optimize(grammar {dictionaries}.size());
+	});
+
+	runner.run("grammar::load (mapped)", options, 0, [&]
+	{
+	    do_not_optimize(grammar::load(path.c_str(), dictionaries));
+	});
+
+	std::filesystem::remove(path);
+    }
+
+    // Writing a child command line back from a parsed option_map, against
+    // the std::string per token it replaces.
+    void bench_canonical_argv(runner& runner, std::size_t options,
+			      std::size_t tokens)
+    {
+	synthetic_grammar grammar {options};
+
+	synthetic_command_line command_line {grammar, tokens};
+
+	parser parser {grammar.get()};
+
+	parser.parse_command_line(command_line.argc(), command_line.argv());
+
+	option_map map {grammar.get()};
+
+	map.add_command_line_options(parser.options());
+
+	runner.run("canonical_argv", options, tokens, [&]
+	{
+	    const canonical_argv argv {"tool", map};
+
+	    do_not_optimize(argv.data());
+	});
+
+	runner.run("std::string argv", options, tokens, [&]
+	{
+	    std::vector<std::string> strings {"tool"};
+
+	    for (std::size_t id = 0; id < grammar.size(); ++id)
+	    {
+		auto name = grammar.long_name(id);
+
+		if (not map.contains(name))
+		{
+		    continue;
+		}
+
+		for (auto argument : map[name])
+		{
+		    strings.emplace_back(std::string {name} + "=" +
+					 std::string {argument});
+		}
+	    }
+
+	    std::vector<char*> argv;
+
+	    for (auto& string : strings)
+	    {
+		argv.emplace_back(string.data());
+	    }
+
+	    argv.emplace_back(nullptr);
+
+	    do_not_optimize(argv.data());
+	});
+    }
+
+    // The same compiler driver command line through the generic parser,
+    // the generic parser feeding an option_map and the parser generated
+    // from bench_options.spec.
+    void bench_generated_parser(runner& runner)
+    {
+	const char* argv[] = {
+	    "",
+	    "-c",
+	    "-O",
+	    "2",
+	    "-g",
+	    "--std=c++23",
+	    "-I",
+	    "include",
+	    "--include-directory=src",
+	    "-D",
+	    "NDEBUG",
+	    "-j",
+	    "8",
+	    "--werror",
+	    "-o",
+	    "main.o",
+	    "main.cpp",
+	    nullptr
+	};
+
+	int argc = std::size(argv) - 1;
+
+	auto& options = bench_options::options();
+
+	parser parser {options};
+
+	runner.run("parser::parse_command_line (spec)", options.size(), argc - 1,
+		   [&]
+		   {
+		       parser.parse_command_line(argc, argv);
+
+		       do_not_optimize(parser.options());
+		   });
+
+	const option_map empty {options};
+
+	runner.run("parser + option_map (spec)", options.size(), argc - 1, [&]
+	{
+	    parser.parse_command_line(argc, argv);
+
+	    option_map map {empty};
+
+	    map.add_command_line_options(parser.options());
+
+	    do_not_optimize(map["-o"]);
+	});
+
+	bench_options::settings settings;
+
+	runner.run("generated parse (spec)", options.size(), argc - 1, [&]
+	{
+	    do_not_optimize(bench_options::parse(argc, argv, settings));
+
+	    do_not_optimize(settings.output);
+	});
+    }
+
+    void bench_split_arguments(runner& runner, std::size_t tokens)
+    {
+	std::string argument;
+
+	for (std::size_t i = 0; i < tokens; ++i)
+	{
+	    argument += i % 8 == 0 ? ",," : ",";
+	    argument += "value-" + std::to_string(i);
+	}
+
+	runner.run("option_map::split_arguments", 0, tokens, [&]
+	{
+	    do_not_optimize(option_map::split_arguments(argument));
+	});
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const option filter {
+	"-f",
+	"--filter",
+	"-f, --filter <substring>",
+	"run only benchmarks whose name contains substring",
+	option::required::not_required,
+	option::arguments::has_arguments
+    };
+
+    const option output {
+	"-o",
+	"--output",
+	"-o, --output <file>",
+	"write JSON results to file instead of standard output",
+	option::required::not_required,
+	option::arguments::has_arguments
+    };
+
+    const option quick {
+	"-q",
+	"--quick",
+	"-q, --quick",
+	"run the smallest sizes with short batches"
+    };
+
+    const dictionary options {filter, output, quick};
+
+    parser parser {options};
+
+    parser.parse_command_line(argc, argv);
+
+    option_map map {options};
+
+    map.add_command_line_options(parser.options());
+
+    bool is_quick = map.contains("--quick").has_value();
+
+    std::chrono::nanoseconds batch_time = is_quick ?
+	std::chrono::milliseconds {1} :
+	std::chrono::milliseconds {50};
+
+    runner runner {
+	map.contains("--filter") ? map["--filter"].back() : "",
+	batch_time
+    };
+
+    std::size_t limit = is_quick ?
+	1'000 : std::numeric_limits<std::size_t>::max();
+
+    for (auto options : grammar_sizes)
+    {
+	if (options > limit)
+	{
+	    continue;
+	}
+
+	bench_parse_command_line(runner, options, default_token_count);
+	bench_validate(runner, options, default_token_count);
+	bench_add_command_line_options(runner, options, default_token_count);
+	bench_option_map_lookup(runner, options);
+	bench_dictionary_contains(runner, options);
+	bench_grammar_find(runner, options);
+	bench_grammar_load(runner, options);
+    }
+
+    bench_generated_parser(runner);
+
+    for (auto tokens : token_counts)
+    {
+	if (tokens > limit)
+	{
+	    continue;
+	}
+
+	bench_parse_command_line(runner, default_grammar_size, tokens);
+	bench_validate(runner, default_grammar_size, tokens);
+	bench_parse_cache_hit(runner, default_grammar_size, tokens);
+	bench_add_command_line_options(runner, default_grammar_size, tokens);
+	bench_canonical_argv(runner, default_grammar_size, tokens);
+	bench_split_arguments(runner, tokens);
+    }
+
+    if (map.contains("--output"))
+    {
+	std::ofstream out {std::string {map["--output"].back()}};
+
+	runner.write_json(out);
+    }
+
+    else
+    {
+	runner.write_json(std::cout);
+    }
+}
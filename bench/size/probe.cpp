@@ -0,0 +1,42 @@
+#include <cstdio>
+
+#include "core/dictionary.hpp"
+#include "core/option_map.hpp"
+#include "core/option.hpp"
+#include "core/parser.hpp"
+
+// A small tool's worth of library use, built once with and once without
+// exceptions so the difference in code and unwind tables can be compared.
+int main(int argc, char** argv)
+{
+    using namespace cli::core;
+
+    const dictionary options {
+	option {"-h", "--help"},
+	option {"-v", "--verbose"},
+
+	option {
+	    "-o",
+	    "--output",
+	    "-o, --output <file>",
+	    "write results to file",
+	    option::required::not_required,
+	    option::arguments::has_arguments
+	}
+    };
+
+    parser parser {options};
+
+    parser.parse_command_line(argc, argv);
+
+    option_map map {options};
+
+    map.add_command_line_options(parser.options());
+
+    if (map.contains("--output"))
+    {
+	std::printf("%zu\n", map["--output"].size());
+    }
+
+    return parser.positional_options().size() > 0;
+}
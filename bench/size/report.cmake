@@ -0,0 +1,55 @@
+# Prints the sizes of the cli_size_* binaries as JSON.
+#
+#   cmake -DSIZE=<size executable> -DBINARIES=<mode>=<path>;... -P report.cmake
+
+set(SECTIONS .text .eh_frame .eh_frame_hdr .gcc_except_table)
+
+set(RESULTS "")
+
+foreach(BINARY ${BINARIES})
+
+    string(REPLACE "=" ";" BINARY ${BINARY})
+
+    list(GET BINARY 0 MODE)
+    list(GET BINARY 1 PATH)
+
+    execute_process(
+	COMMAND ${SIZE} -A -d ${PATH}
+	OUTPUT_VARIABLE OUTPUT
+	RESULT_VARIABLE RESULT)
+
+    if (NOT RESULT EQUAL 0)
+
+	message(FATAL_ERROR "${SIZE} failed on ${PATH}")
+
+    endif()
+
+    file(SIZE ${PATH} FILE_SIZE)
+
+    set(FIELDS "\"mode\": \"${MODE}\", \"file\": ${FILE_SIZE}")
+
+    foreach(SECTION ${SECTIONS})
+
+	set(SECTION_SIZE 0)
+
+	string(REPLACE "." "\\." PATTERN ${SECTION})
+
+	if (OUTPUT MATCHES "(^|\n)${PATTERN}[ \t]+([0-9]+)")
+
+	    set(SECTION_SIZE ${CMAKE_MATCH_2})
+
+	endif()
+
+	string(SUBSTRING ${SECTION} 1 -1 NAME)
+
+	string(APPEND FIELDS ", \"${NAME}\": ${SECTION_SIZE}")
+
+    endforeach()
+
+    list(APPEND RESULTS "    {${FIELDS}}")
+
+endforeach()
+
+list(JOIN RESULTS ",\n" RESULTS)
+
+message("{\n  \"sizes\": [\n${RESULTS}\n  ]\n}")
@@ -0,0 +1,287 @@
+#include <string_view>
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+#include <time.h>
+
+#include "core/dictionary.hpp"
+#include "core/option_map.hpp"
+#include "core/option.hpp"
+#include "core/parser.hpp"
+
+#include "startup_targets.hpp"
+
+using namespace cli::core;
+
+namespace
+{
+    struct sample
+    {
+	std::int64_t  elapsed_ns  = 0;
+	std::uint64_t allocations = 0;
+    };
+
+    struct result
+    {
+	std::size_t options        = 0;
+	std::size_t with_arguments = 0;
+	std::size_t tokens         = 0;
+	std::size_t runs           = 0;
+
+	std::int64_t median_ns = 0;
+	std::int64_t p90_ns    = 0;
+	std::int64_t min_ns    = 0;
+
+	std::uint64_t allocations = 0;
+    };
+
+    std::int64_t monotonic_ns() noexcept
+    {
+	timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return static_cast<std::int64_t>(now.tv_sec) * 1'000'000'000 +
+	    now.tv_nsec;
+    }
+
+    // A command line a real tool might see: a handful of options, some
+    // with separate arguments and some with --name=value. Options at even
+    // indexes take arguments, as bench/CMakeLists.txt generates them.
+    std::vector<std::string> make_command_line(std::size_t options)
+    {
+	std::vector<std::string> tokens;
+
+	for (std::size_t i = 0; i < options && i < 12; ++i)
+	{
+	    auto name = "--option-" + std::to_string(i);
+
+	    if (i % 2 == 1)
+	    {
+		tokens.emplace_back(name);
+	    }
+
+	    else if (i % 4 == 0)
+	    {
+		tokens.emplace_back(name);
+		tokens.emplace_back("value");
+	    }
+
+	    else
+	    {
+		tokens.emplace_back(name + "=a,b");
+	    }
+	}
+
+	return tokens;
+    }
+
+    // The child reads the clock immediately before execv and the target
+    // reads it again once its option_map is filled; both timestamps and
+    // the target's allocation count arrive on the child's stdout.
+    sample run_once(const char* path, std::vector<const char*>& argv)
+    {
+	int pipe_fds[2];
+
+	if (pipe(pipe_fds) != 0)
+	{
+	    std::perror("pipe");
+	    std::exit(EXIT_FAILURE);
+	}
+
+	pid_t pid = fork();
+
+	if (pid < 0)
+	{
+	    std::perror("fork");
+	    std::exit(EXIT_FAILURE);
+	}
+
+	if (pid == 0)
+	{
+	    dup2(pipe_fds[1], STDOUT_FILENO);
+
+	    close(pipe_fds[0]);
+	    close(pipe_fds[1]);
+
+	    char line[64];
+
+	    int size = std::snprintf(line, sizeof(line), "exec %lld\n",
+				     static_cast<long long>(monotonic_ns()));
+
+	    if (write(STDOUT_FILENO, line, size) != size)
+	    {
+		_exit(EXIT_FAILURE);
+	    }
+
+	    execv(path, const_cast<char* const*>(argv.data()));
+
+	    _exit(EXIT_FAILURE);
+	}
+
+	close(pipe_fds[1]);
+
+	std::string output;
+
+	char buffer[256];
+
+	for (ssize_t size; (size = read(pipe_fds[0], buffer, sizeof(buffer))) > 0;)
+	{
+	    output.append(buffer, size);
+	}
+
+	close(pipe_fds[0]);
+
+	int status = 0;
+
+	waitpid(pid, &status, 0);
+
+	long long exec_ns  = 0;
+	long long ready_ns = 0;
+
+	unsigned long long allocations = 0;
+
+	if (not WIFEXITED(status) || WEXITSTATUS(status) != 0 ||
+	    std::sscanf(output.c_str(), "exec %lld\nready %lld %llu",
+			&exec_ns, &ready_ns, &allocations) != 3)
+	{
+	    std::cerr << path << ": unexpected output '" << output << "'\n";
+	    std::exit(EXIT_FAILURE);
+	}
+
+	return {ready_ns - exec_ns, allocations};
+    }
+
+    result run(const startup_target& target, std::size_t runs)
+    {
+	auto tokens = make_command_line(target.options);
+
+	std::vector<const char*> argv {target.path};
+
+	for (auto&& token : tokens)
+	{
+	    argv.emplace_back(token.c_str());
+	}
+
+	argv.emplace_back(nullptr);
+
+	run_once(target.path, argv);
+
+	std::vector<std::int64_t> elapsed;
+
+	std::uint64_t allocations = 0;
+
+	for (std::size_t i = 0; i < runs; ++i)
+	{
+	    auto sample = run_once(target.path, argv);
+
+	    elapsed.emplace_back(sample.elapsed_ns);
+
+	    allocations = std::max(allocations, sample.allocations);
+	}
+
+	std::sort(elapsed.begin(), elapsed.end());
+
+	return {
+	    target.options,
+	    (target.options + 1) / 2,
+	    tokens.size(),
+	    runs,
+	    elapsed[elapsed.size() / 2],
+	    elapsed[elapsed.size() * 9 / 10],
+	    elapsed.front(),
+	    allocations
+	};
+    }
+
+    void write_json(std::ostream& out, const std::vector<result>& results)
+    {
+	out << "{\n  \"benchmarks\": [";
+
+	for (std::size_t i = 0; i < results.size(); ++i)
+	{
+	    auto& result = results[i];
+
+	    out << (i == 0 ? "\n" : ",\n")
+		<< "    {\"name\": \"startup\""
+		<< ", \"options\": "        << result.options
+		<< ", \"with_arguments\": " << result.with_arguments
+		<< ", \"tokens\": "         << result.tokens
+		<< ", \"runs\": "           << result.runs
+		<< ", \"median_ns\": "      << result.median_ns
+		<< ", \"p90_ns\": "         << result.p90_ns
+		<< ", \"min_ns\": "         << result.min_ns
+		<< ", \"allocations\": "    << result.allocations
+		<< "}";
+	}
+
+	out << "\n  ]\n}\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const option runs {
+	"-r",
+	"--runs",
+	"-r, --runs <count>",
+	"exec every target count times",
+	option::required::not_required,
+	option::arguments::has_arguments
+    };
+
+    const option output {
+	"-o",
+	"--output",
+	"-o, --output <file>",
+	"write JSON results to file instead of standard output",
+	option::required::not_required,
+	option::arguments::has_arguments
+    };
+
+    const dictionary options {runs, output};
+
+    parser parser {options};
+
+    parser.parse_command_line(argc, argv);
+
+    option_map map {options};
+
+    map.add_command_line_options(parser.options());
+
+    std::size_t run_count = 200;
+
+    if (map.contains("--runs"))
+    {
+	run_count = std::max(
+	    1, std::atoi(std::string {map["--runs"].back()}.c_str()));
+    }
+
+    std::vector<result> results;
+
+    for (auto&& target : startup_targets)
+    {
+	results.emplace_back(run(target, run_count));
+    }
+
+    if (map.contains("--output"))
+    {
+	std::ofstream out {std::string {map["--output"].back()}};
+
+	write_json(out, results);
+    }
+
+    else
+    {
+	write_json(std::cout, results);
+    }
+}
@@ -0,0 +1,60 @@
+#include <cstddef>
+#include <cstdlib>
+#include <cstdio>
+#include <new>
+
+#include <time.h>
+
+#include "core/option_map.hpp"
+#include "core/parser.hpp"
+
+#include "startup_options.hpp"
+
+// Counts every allocation from process start, including the ones made
+// while the global options in startup_options.hpp are constructed.
+namespace
+{
+    std::size_t allocations = 0;
+}
+
+void* operator new(std::size_t size)
+{
+    ++allocations;
+
+    if (void* pointer = std::malloc(size == 0 ? 1 : size))
+    {
+	return pointer;
+    }
+
+    std::abort();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+int main(int argc, char** argv)
+{
+    cli::core::parser parser {startup::options};
+
+    parser.parse_command_line(argc, argv);
+
+    cli::core::option_map map {startup::options};
+
+    map.add_command_line_options(parser.options());
+
+    timespec ready;
+
+    clock_gettime(CLOCK_MONOTONIC, &ready);
+
+    std::printf("ready %lld %zu\n",
+		static_cast<long long>(ready.tv_sec) * 1'000'000'000 +
+		ready.tv_nsec,
+		allocations);
+}
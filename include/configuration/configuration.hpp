@@ -1 +1,4 @@
 #include "exception_source_information.hpp"
+#include "instrumentation.hpp"
+#include "exceptions.hpp"
+#include "tracing.hpp"
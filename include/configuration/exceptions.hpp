@@ -0,0 +1,11 @@
+#pragma once
+
+#if defined(__cpp_exceptions) && not defined(DISABLE_EXCEPTIONS)
+
+#define EXCEPTIONS_ENABLED 1
+
+#else
+
+#define EXCEPTIONS_ENABLED 0
+
+#endif
@@ -0,0 +1,15 @@
+#pragma once
+
+#ifndef DISABLE_INSTRUMENTATION
+
+#define INSTRUMENTATION_ENABLED 1
+
+#define INSTRUMENT(...) __VA_ARGS__
+
+#else
+
+#define INSTRUMENTATION_ENABLED 0
+
+#define INSTRUMENT(...)
+
+#endif
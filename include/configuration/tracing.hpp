@@ -0,0 +1,15 @@
+#pragma once
+
+#if defined(ENABLE_TRACEPOINTS) && __has_include(<sys/sdt.h>)
+
+#include <sys/sdt.h>
+
+// Static probes under the "cli" provider; each site is a single nop until
+// a tracer attaches, e.g. bpftrace -e 'usdt:./tool:cli:parse__start {...}'.
+#define TRACEPOINT(...) STAP_PROBEV(cli, __VA_ARGS__)
+
+#else
+
+#define TRACEPOINT(...)
+
+#endif
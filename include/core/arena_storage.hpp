@@ -0,0 +1,119 @@
+#pragma once
+
+#include <memory_resource>
+#include <cstddef>
+
+namespace cli::core
+{
+    // One block of bytes from a memory resource, for classes keeping views
+    // or pointers together with what they refer to in a single allocation.
+    // Moving the storage keeps the block where it is, so everything
+    // pointing into it stays valid.
+    class arena_storage final
+    {
+    public:
+
+	using allocator_type = std::pmr::polymorphic_allocator<>;
+
+	arena_storage() = default;
+
+	explicit arena_storage(const allocator_type& allocator) noexcept :
+	    allocator {allocator}
+	{}
+
+	arena_storage(const arena_storage&) = delete;
+
+	arena_storage(arena_storage&& other) noexcept :
+	    allocator  {other.allocator},
+	    data_      {other.data_},
+	    size_      {other.size_},
+	    alignment_ {other.alignment_}
+	{
+	    other.release_ownership();
+	}
+
+	~arena_storage()
+	{
+	    release();
+	}
+
+	arena_storage& operator=(const arena_storage&) = delete;
+
+	arena_storage& operator=(arena_storage&&) = delete;
+
+	// Replaces the block with a new one of size bytes.
+	void allocate(std::size_t size, std::size_t alignment)
+	{
+	    release();
+
+	    data_      = allocator.allocate_bytes(size, alignment);
+	    size_      = size;
+	    alignment_ = alignment;
+	}
+
+	// Takes over the block of other. pmr allocators do not propagate, so
+	// a block from another memory resource cannot be taken over; false
+	// is returned and the owner copies its contents with this allocator
+	// instead.
+	bool take_over(arena_storage& other) noexcept
+	{
+	    if (allocator != other.allocator)
+	    {
+		return false;
+	    }
+
+	    if (this != &other)
+	    {
+		release();
+
+		data_      = other.data_;
+		size_      = other.size_;
+		alignment_ = other.alignment_;
+
+		other.release_ownership();
+	    }
+
+	    return true;
+	}
+
+	void release() noexcept
+	{
+	    if (data_)
+	    {
+		allocator.deallocate_bytes(data_, size_, alignment_);
+
+		release_ownership();
+	    }
+	}
+
+	void* data() const noexcept
+	{
+	    return data_;
+	}
+
+	std::size_t size() const noexcept
+	{
+	    return size_;
+	}
+
+	allocator_type get_allocator() const noexcept
+	{
+	    return allocator;
+	}
+
+    private:
+
+	void release_ownership() noexcept
+	{
+	    data_      = nullptr;
+	    size_      = 0;
+	    alignment_ = 0;
+	}
+
+	allocator_type allocator;
+
+	void*       data_      = nullptr;
+	std::size_t size_      = 0;
+	std::size_t alignment_ = 0;
+    };
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <memory_resource>
+#include <string_view>
+#include <cstddef>
+#include <utility>
+#include <span>
+
+#include "core/arena_storage.hpp"
+#include "core/option_map.hpp"
+
+namespace cli::core
+{
+    // The command line an option_map was parsed from, written back in
+    // canonical form: argv[0], then every option in grammar id order
+    // under its long name (its short name if it has none), one token or
+    // pair of tokens per argument, then the positional options. Pointers
+    // and NUL-terminated strings share one allocation; data() is what
+    // posix_spawn and execv expect.
+    //
+    // Parsing the result into an option_map over the same dictionaries
+    // gives back the same options and arguments, and writing that map
+    // gives the same argv again. Arguments no form would read back as
+    // written, such as an empty joined argument or an option-like
+    // positional option, raise argument_cannot_be_written. An option that
+    // takes arguments but has none, from the map or an override, raises
+    // option_expects_argument as the parser would on reading it back.
+    class canonical_argv final
+    {
+    public:
+
+	using allocator_type = std::pmr::polymorphic_allocator<>;
+	using value_type     = char*;
+	using size_type      = std::size_t;
+	using const_iterator = char* const*;
+
+	// How an argument follows a long option name: --name=value in one
+	// token, or --name value in two. Options without a long name always
+	// take two tokens; arguments with a comma, which option_map would
+	// split, or that look like an option fall back to the form that
+	// reads them back unchanged.
+	enum class argument_style
+	{
+	    joined = 0,
+	    separate
+	};
+
+	// Replaces the arguments of an option, adds the option when the map
+	// lacks it, or with remove set leaves it out.
+	struct option_override final
+	{
+	    std::string_view                  option;
+	    std::span<const std::string_view> arguments;
+	    bool                              remove = false;
+	};
+
+	canonical_argv(
+	    std::string_view                  program,
+	    const option_map&                 map,
+	    std::span<const option_override>  overrides          = {},
+	    std::span<const std::string_view> positional_options = {},
+	    argument_style                    style = argument_style::joined,
+	    const allocator_type&                                = {});
+
+	canonical_argv(const canonical_argv& other) :
+	    canonical_argv {other, other.get_allocator()}
+	{}
+
+	canonical_argv(const canonical_argv&, const allocator_type&);
+
+	canonical_argv(canonical_argv&& other) noexcept :
+	    storage {std::move(other.storage)},
+	    argv    {std::exchange(other.argv, nullptr)},
+	    size_   {std::exchange(other.size_, 0)}
+	{}
+
+	canonical_argv& operator=(const canonical_argv& other)
+	{
+	    if (this != &other)
+	    {
+		*this = canonical_argv {other, get_allocator()};
+	    }
+
+	    return *this;
+	}
+
+	canonical_argv& operator=(canonical_argv&&);
+
+	// nullptr terminated, size() + 1 entries long.
+	char* const* data() const noexcept
+	{
+	    return argv;
+	}
+
+	const_iterator begin() const noexcept
+	{
+	    return argv;
+	}
+
+	const_iterator end() const noexcept
+	{
+	    return argv + size_;
+	}
+
+	const char* operator[](size_type position) const noexcept
+	{
+	    return argv[position];
+	}
+
+	// Entries before the terminating nullptr, argv[0] included.
+	size_type size() const noexcept
+	{
+	    return size_;
+	}
+
+	// Bytes held for the pointers and the strings.
+	std::size_t arena_size() const noexcept
+	{
+	    return storage.size();
+	}
+
+	allocator_type get_allocator() const noexcept
+	{
+	    return storage.get_allocator();
+	}
+
+    private:
+
+	void allocate(size_type tokens, std::size_t bytes);
+
+	arena_storage storage;
+
+	char**    argv  = nullptr;
+	size_type size_ = 0;
+    };
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <memory_resource>
+#include <cstddef>
+#include <utility>
+#include <span>
+
+#include "core/arena_storage.hpp"
+#include "core/parser.hpp"
+
+namespace cli::core
+{
+    // The argv of a program a wrapper runs: a prefix such as the program
+    // path, every run a parser passed through in command line order and
+    // the terminating nullptr, in one allocation. The strings are not
+    // copied, so the parsed argv must outlive it; data() is what execv
+    // and posix_spawn expect.
+    class child_argv final
+    {
+    public:
+
+	using allocator_type    = std::pmr::polymorphic_allocator<>;
+	using value_type        = char*;
+	using size_type         = std::size_t;
+	using const_iterator    = char* const*;
+	using pass_through_type = std::span<const char* const>;
+
+	child_argv(std::span<const char* const>      prefix,
+		   std::span<const pass_through_type> pass_through,
+		   const allocator_type& = {});
+
+	template<
+	    typename LookupPolicy,
+	    typename StoragePolicy,
+	    typename ErrorPolicy,
+	    typename Allocator
+	>
+	child_argv(
+	    const char* program,
+	    const basic_parser<
+		LookupPolicy, StoragePolicy, ErrorPolicy, Allocator
+	    >& parser,
+	    const allocator_type& allocator = {})
+	    :
+	    child_argv {
+		std::span {&program, 1},
+		std::span {
+		    parser.pass_through().data(),
+		    parser.pass_through().size()
+		},
+		allocator
+	    }
+	{}
+
+	child_argv(const child_argv& other) :
+	    child_argv {other, other.get_allocator()}
+	{}
+
+	child_argv(const child_argv& other, const allocator_type& allocator) :
+	    child_argv {
+		pass_through_type {other.data(), other.size()},
+		{},
+		allocator
+	    }
+	{}
+
+	child_argv(child_argv&& other) noexcept :
+	    storage {std::move(other.storage)},
+	    argv    {std::exchange(other.argv, nullptr)},
+	    size_   {std::exchange(other.size_, 0)}
+	{}
+
+	child_argv& operator=(const child_argv& other)
+	{
+	    if (this != &other)
+	    {
+		*this = child_argv {other, get_allocator()};
+	    }
+
+	    return *this;
+	}
+
+	child_argv& operator=(child_argv&&);
+
+	// nullptr terminated, size() + 1 entries long.
+	char* const* data() const noexcept
+	{
+	    return argv;
+	}
+
+	const_iterator begin() const noexcept
+	{
+	    return argv;
+	}
+
+	const_iterator end() const noexcept
+	{
+	    return argv + size_;
+	}
+
+	const char* operator[](size_type position) const noexcept
+	{
+	    return argv[position];
+	}
+
+	// Entries before the terminating nullptr.
+	size_type size() const noexcept
+	{
+	    return size_;
+	}
+
+	allocator_type get_allocator() const noexcept
+	{
+	    return storage.get_allocator();
+	}
+
+    private:
+
+	arena_storage storage;
+
+	char**    argv  = nullptr;
+	size_type size_ = 0;
+    };
+}
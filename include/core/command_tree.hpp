@@ -0,0 +1,80 @@
+#pragma once
+
+#include <initializer_list>
+#include <string_view>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "core/parser.hpp"
+
+namespace cli::core
+{
+    class command_tree final
+    {
+    public:
+
+	using registration = void (*)(parser&);
+
+	static constexpr std::size_t npos = -1;
+
+	struct selection final
+	{
+	    std::size_t command = npos;
+	    int         depth   = 0;
+	};
+
+	command_tree() :
+	    nodes {node {}}
+	{}
+
+	// The names of the path are copied, so they need not outlive the
+	// call.
+	std::size_t
+	add_command(std::initializer_list<std::string_view>, registration);
+
+	selection select(int, const char**) const noexcept;
+
+	selection select(int argc, char** argv) const noexcept
+	{
+	    return select(argc, const_cast<const char**>(argv));
+	}
+
+	// Clears the dictionaries of parser before calling the registration
+	// of the selected command, so a parser reused across dispatches only
+	// knows that command's options. Its other settings are kept.
+	selection dispatch(int, const char**, parser&) const;
+
+	selection dispatch(int argc, char** argv, parser& parser) const
+	{
+	    return dispatch(argc, const_cast<const char**>(argv), parser);
+	}
+
+	bool empty() const noexcept
+	{
+	    return size() == 0;
+	}
+
+	std::size_t size() const noexcept
+	{
+	    return commands.size();
+	}
+
+    private:
+
+	struct node final
+	{
+	    std::string  name;
+	    registration thunk = nullptr;
+	    std::size_t  id    = npos;
+
+	    std::size_t first_child  = npos;
+	    std::size_t next_sibling = npos;
+	};
+
+	std::size_t find_child(std::size_t, std::string_view) const noexcept;
+
+	std::vector<node>        nodes;
+	std::vector<std::size_t> commands;
+    };
+}
@@ -1,4 +1,18 @@
+#include "reloadable_options.hpp"
+#include "owned_command_line.hpp"
+#include "shared_dictionary.hpp"
+#include "parser_policies.hpp"
+#include "option_snapshot.hpp"
+#include "canonical_argv.hpp"
+#include "arena_storage.hpp"
+#include "inline_vector.hpp"
+#include "command_tree.hpp"
+#include "parse_event.hpp"
+#include "parse_cache.hpp"
+#include "diagnostic.hpp"
 #include "option_map.hpp"
 #include "dictionary.hpp"
+#include "child_argv.hpp"
+#include "grammar.hpp"
 #include "parser.hpp"
 #include "option.hpp"
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+
+#include "core/grammar.hpp"
+
+namespace cli::core
+{
+    // A parse error as recorded by the collect_errors policy: what went
+    // wrong, at which argv index and for which option of the grammar.
+    struct diagnostic final
+    {
+	enum class kind : std::uint8_t
+	{
+	    unrecognized_option = 0,
+	    ambiguous_option,
+	    option_already_added_as,
+	    option_expects_argument,
+	    option_is_required_but_not_added
+	};
+
+	// index of errors not tied to a token, such as a missing required
+	// option.
+	static constexpr int no_index = -1;
+
+	kind               type  = kind::unrecognized_option;
+	int                index = no_index;
+	grammar::size_type id    = grammar::npos;
+    };
+}
@@ -11,6 +11,8 @@
 
 #include "option.hpp"
 
+#include "generic/error_handler.hpp"
+
 namespace cli::core
 {
     class dictionary final
@@ -33,6 +35,11 @@ namespace cli::core
 	    container_ {initializer_list}
 	{}
 
+	template<typename InputIterator>
+	dictionary(InputIterator first, InputIterator last) :
+	    container_ (first, last)
+	{}
+
 	dictionary(const dictionary&) = default;
 
 	dictionary(dictionary&& other) noexcept :
@@ -120,7 +127,7 @@ namespace cli::core
 		return *iterator;
 	    }
 
-	    throw std::out_of_range {EXCEPTION_SOURCE_INFORMATION};
+	    generic::raise(std::out_of_range {EXCEPTION_SOURCE_INFORMATION});
 	}
 
 	reference operator[](const_reference option)
@@ -142,7 +149,7 @@ namespace cli::core
 		return *iterator;
 	    }
 
-	    throw std::out_of_range {EXCEPTION_SOURCE_INFORMATION};
+	    generic::raise(std::out_of_range {EXCEPTION_SOURCE_INFORMATION});
 	}
 
 	reference operator[](std::string_view option_name)
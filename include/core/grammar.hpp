@@ -0,0 +1,362 @@
+#pragma once
+
+#include <initializer_list>
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <array>
+#include <span>
+
+#include "shared_dictionary.hpp"
+#include "parse_stats.hpp"
+#include "option.hpp"
+
+namespace cli::core
+{
+    class grammar final
+    {
+    public:
+
+	using size_type = std::size_t;
+
+	static constexpr size_type npos      = -1;
+	static constexpr size_type ambiguous = -2;
+
+	// How long option names are looked up. automatic picks one from the
+	// number of names and their lengths when the grammar is built.
+	enum class lookup_strategy
+	{
+	    automatic = 0,
+	    linear,
+	    binary_search,
+	    hash,
+	    trie
+	};
+
+	grammar() noexcept
+	{
+	    built.short_table.fill(npos_id);
+
+	    view_built();
+	}
+
+	explicit grammar(std::span<const shared_dictionary>,
+			 lookup_strategy = lookup_strategy::automatic);
+
+	explicit grammar(
+	    std::initializer_list<shared_dictionary> dictionaries,
+	    lookup_strategy strategy = lookup_strategy::automatic) :
+	    grammar {
+		std::span {dictionaries.begin(), dictionaries.size()},
+		strategy
+	    }
+	{}
+
+	// Lookups view the index, so a grammar stays where it was built.
+	grammar(const grammar&) = delete;
+
+	grammar& operator=(const grammar&) = delete;
+
+	size_type find(std::string_view, parse_stats* = nullptr) const noexcept;
+
+	size_type
+	find_abbreviated(std::string_view, parse_stats* = nullptr) const noexcept;
+
+	// find and find_abbreviated with the long name lookup fixed at
+	// compile time, for grammars whose strategy() is Strategy; automatic
+	// looks up as the grammar's strategy says at run time.
+	template<lookup_strategy Strategy>
+	size_type
+	find(std::string_view option_name,
+	     parse_stats*     stats = nullptr) const noexcept
+	{
+	    if (Strategy == lookup_strategy::automatic ||
+		is_short_option_name(option_name))
+	    {
+		return find(option_name, stats);
+	    }
+
+	    auto found = find_long<Strategy>(option_name, false, stats);
+
+	    return find_validated(option_name, found, stats);
+	}
+
+	template<lookup_strategy Strategy>
+	size_type
+	find_abbreviated(std::string_view option_name,
+			 parse_stats*     stats = nullptr) const noexcept
+	{
+	    if (Strategy == lookup_strategy::automatic ||
+		is_short_option_name(option_name))
+	    {
+		return find_abbreviated(option_name, stats);
+	    }
+
+	    auto found = find_long<Strategy>(option_name, true, stats);
+
+	    return find_validated(option_name, found, stats);
+	}
+
+	// presence holds the bits of ids from first_word * 64 on.
+	size_type find_missing_required(
+	    std::span<const std::uint64_t> presence,
+	    size_type                      first_word = 0) const noexcept;
+
+	bool empty() const noexcept
+	{
+	    return options.empty();
+	}
+
+	std::uint64_t fingerprint() const noexcept
+	{
+	    return fingerprint_;
+	}
+
+	bool has_arguments(size_type id) const noexcept
+	{
+	    return test(arguments, id);
+	}
+
+	bool is_required(size_type id) const noexcept
+	{
+	    return test(required, id);
+	}
+
+	size_type size() const noexcept
+	{
+	    return options.size();
+	}
+
+	lookup_strategy strategy() const noexcept
+	{
+	    return strategy_;
+	}
+
+	const option& operator[](size_type id) const noexcept
+	{
+	    return *options[id];
+	}
+
+	static std::shared_ptr<const grammar>
+	compile(std::span<const shared_dictionary>,
+		lookup_strategy = lookup_strategy::automatic);
+
+	// Maps a grammar file written by save and uses its index in place,
+	// without building one. The file is only used when its format, the
+	// layout of its tables and the grammar fingerprint all match; the
+	// dictionaries are compiled otherwise. Either way the grammar is
+	// interned as compile would, so parsers built from the same
+	// dictionaries share it while it is alive.
+	static std::shared_ptr<const grammar>
+	load(const char* path,
+	     std::span<const shared_dictionary>,
+	     lookup_strategy = lookup_strategy::automatic);
+
+	// Returns whether the file was written.
+	bool save(const char* path) const;
+
+	// Whether the index is mapped from a grammar file.
+	bool mapped() const noexcept
+	{
+	    return mapping != nullptr;
+	}
+
+	static bool
+	test(std::span<const std::uint64_t> bits, size_type id) noexcept
+	{
+	    return (bits[id / 64] >> (id % 64)) & 1;
+	}
+
+	static void
+	set(std::span<std::uint64_t> bits, size_type id) noexcept
+	{
+	    bits[id / 64] |= std::uint64_t {1} << (id % 64);
+	}
+
+    private:
+
+	static constexpr std::uint32_t npos_id      = -1;
+	static constexpr std::uint32_t ambiguous_id = -2;
+
+	static constexpr std::size_t linear_limit     = 8;
+	static constexpr std::size_t trie_limit       = 128;
+	static constexpr std::size_t trie_name_length = 24;
+
+	struct name final
+	{
+	    std::uint32_t offset = 0;
+	    std::uint32_t size   = 0;
+	};
+
+	struct trie_node final
+	{
+	    std::uint32_t label_offset = 0;
+	    std::uint32_t label_size   = 0;
+	    std::uint32_t first_child  = 0;
+	    std::uint16_t children     = 0;
+	    unsigned char first        = 0;
+	    std::uint32_t terminal     = npos_id;
+	    std::uint32_t unique       = npos_id;
+	};
+
+	struct sorted_name final
+	{
+	    std::uint32_t offset = 0;
+	    std::uint32_t size   = 0;
+	    std::uint32_t id     = 0;
+	};
+
+	struct trie_entry;
+
+	static lookup_strategy
+	select_strategy(std::span<const sorted_name>) noexcept;
+
+	void build_hash();
+
+	void build_trie(std::vector<trie_entry>&);
+
+	void build_trie_node(
+	    std::vector<trie_entry>&,
+	    std::size_t,
+	    std::size_t,
+	    std::size_t,
+	    std::size_t);
+
+	size_type find_long(std::string_view, bool, parse_stats*) const noexcept;
+
+	template<lookup_strategy Strategy>
+	size_type
+	find_long(std::string_view option_name,
+		  bool             abbreviated,
+		  parse_stats*     stats) const noexcept
+	{
+	    if constexpr (Strategy == lookup_strategy::linear)
+	    {
+		return find_linear(option_name, abbreviated, stats);
+	    }
+
+	    else if constexpr (Strategy == lookup_strategy::binary_search)
+	    {
+		return find_sorted(option_name, abbreviated, stats);
+	    }
+
+	    else if constexpr (Strategy == lookup_strategy::hash)
+	    {
+		return find_hashed(option_name, abbreviated, stats);
+	    }
+
+	    else if constexpr (Strategy == lookup_strategy::trie)
+	    {
+		return find_trie(option_name, abbreviated, stats);
+	    }
+
+	    else
+	    {
+		return find_long(option_name, abbreviated, stats);
+	    }
+	}
+
+	size_type find_linear(std::string_view, bool, parse_stats*) const noexcept;
+
+	size_type find_sorted(std::string_view, bool, parse_stats*) const noexcept;
+
+	size_type find_hashed(std::string_view, bool, parse_stats*) const noexcept;
+
+	size_type find_trie(std::string_view, bool, parse_stats*) const noexcept;
+
+	static size_type prefix_match(std::uint32_t, bool) noexcept;
+
+	std::string_view long_name(std::uint32_t id) const noexcept
+	{
+	    return {names.data() + long_names[id].offset, long_names[id].size};
+	}
+
+	std::string_view name_at(const sorted_name& name) const noexcept
+	{
+	    return {names.data() + name.offset, name.size};
+	}
+
+	size_type
+	find_validated(std::string_view, size_type, parse_stats*) const noexcept;
+
+	struct built_index final
+	{
+	    std::array<std::uint32_t, 256> short_table;
+
+	    std::string                names;
+	    std::vector<unsigned char> short_names;
+	    std::vector<name>          long_names;
+	    std::vector<sorted_name>   sorted;
+	    std::vector<std::uint32_t> hashed;
+	    std::vector<trie_node>     trie;
+	    std::vector<std::uint64_t> required;
+	    std::vector<std::uint64_t> arguments;
+	    std::vector<std::uint32_t> validated;
+	};
+
+	struct file_header;
+
+	grammar(std::span<const shared_dictionary>,
+		lookup_strategy,
+		std::vector<const option*>,
+		std::shared_ptr<const void>,
+		const file_header&);
+
+	void view_built() noexcept
+	{
+	    short_table = built.short_table;
+	    names       = built.names;
+	    short_names = built.short_names;
+	    long_names  = built.long_names;
+	    sorted      = built.sorted;
+	    hashed      = built.hashed;
+	    trie        = built.trie;
+	    required    = built.required;
+	    arguments   = built.arguments;
+	    validated   = built.validated;
+	}
+
+	std::vector<std::byte> serialize() const;
+
+	// Whether every id, index and offset in the tables is in range, as
+	// lookups take them on trust.
+	bool valid_tables() const noexcept;
+
+	static std::uint64_t fingerprint(std::uint64_t, const option&) noexcept;
+
+	// Returns the live grammar of the dictionaries, or the one make
+	// returns, registered for the next caller.
+	template<typename Make>
+	static std::shared_ptr<const grammar>
+	intern(std::span<const shared_dictionary>, lookup_strategy, Make&&);
+
+	std::vector<shared_dictionary> dictionaries;
+
+	built_index built;
+
+	// The mapped grammar file, if the index was loaded from one.
+	std::shared_ptr<const void> mapping;
+
+	// The index used by lookups, viewing either built or mapping.
+	std::span<const std::uint32_t> short_table;
+	std::string_view               names;
+	std::span<const unsigned char> short_names;
+	std::span<const name>          long_names;
+	std::span<const sorted_name>   sorted;
+	std::span<const std::uint32_t> hashed;
+	std::span<const trie_node>     trie;
+	std::span<const std::uint64_t> required;
+	std::span<const std::uint64_t> arguments;
+	std::span<const std::uint32_t> validated;
+
+	std::vector<const option*> options;
+
+	std::uint64_t fingerprint_ = 0;
+
+	lookup_strategy requested = lookup_strategy::automatic;
+	lookup_strategy strategy_ = lookup_strategy::linear;
+    };
+}
@@ -0,0 +1,269 @@
+#pragma once
+
+#include <type_traits>
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <memory>
+#include <array>
+
+namespace cli::core
+{
+    // A vector of trivially copyable values that keeps its first N
+    // elements inside the object and only asks the allocator for memory
+    // once they are exceeded.
+    template<typename T, std::size_t N, typename Allocator = std::allocator<T>>
+    class inline_vector
+    {
+	static_assert(std::is_trivially_copyable_v<T>);
+	static_assert(N > 0);
+
+	using traits = std::allocator_traits<Allocator>;
+
+    public:
+
+	using allocator_type  = Allocator;
+	using value_type      = T;
+	using reference       = T&;
+	using const_reference = const T&;
+	using size_type       = std::size_t;
+	using iterator        = T*;
+	using const_iterator  = const T*;
+
+	inline_vector() = default;
+
+	explicit inline_vector(const allocator_type& allocator) noexcept :
+	    allocator_ {allocator}
+	{}
+
+	inline_vector(const inline_vector& other) :
+	    inline_vector {
+		other,
+		traits::select_on_container_copy_construction(other.allocator_)
+	    }
+	{}
+
+	inline_vector(const inline_vector& other,
+		      const allocator_type& allocator) :
+	    allocator_ {allocator}
+	{
+	    assign(other.begin(), other.end());
+	}
+
+	inline_vector(inline_vector&& other) noexcept :
+	    allocator_ {other.allocator_}
+	{
+	    if (other.is_inline())
+	    {
+		std::copy(other.begin(), other.end(), buffer.begin());
+	    }
+
+	    else
+	    {
+		data_      = other.data_;
+		capacity_  = other.capacity_;
+
+		other.data_     = other.buffer.data();
+		other.capacity_ = N;
+	    }
+
+	    size_       = other.size_;
+	    other.size_ = 0;
+	}
+
+	~inline_vector()
+	{
+	    release();
+	}
+
+	inline_vector& operator=(const inline_vector& other)
+	{
+	    if (this != &other)
+	    {
+		assign(other.begin(), other.end());
+	    }
+
+	    return *this;
+	}
+
+	inline_vector& operator=(inline_vector&& other)
+	{
+	    if (this != &other)
+	    {
+		if (other.is_inline() || allocator_ != other.allocator_)
+		{
+		    assign(other.begin(), other.end());
+
+		    other.clear();
+		}
+
+		else
+		{
+		    release();
+
+		    data_     = other.data_;
+		    size_     = other.size_;
+		    capacity_ = other.capacity_;
+
+		    other.data_     = other.buffer.data();
+		    other.size_     = 0;
+		    other.capacity_ = N;
+		}
+	    }
+
+	    return *this;
+	}
+
+	template<typename InputIterator>
+	void assign(InputIterator first, InputIterator last)
+	{
+	    auto size = static_cast<size_type>(std::distance(first, last));
+
+	    size_ = 0;
+
+	    if (size > capacity_)
+	    {
+		reallocate(size);
+	    }
+
+	    std::copy(first, last, data_);
+
+	    size_ = size;
+	}
+
+	template<typename... Args>
+	reference emplace_back(Args&&... args)
+	{
+	    if (size_ == capacity_)
+	    {
+		reallocate(capacity_ * 2);
+	    }
+
+	    return data_[size_++] = T(std::forward<Args>(args)...);
+	}
+
+	void clear() noexcept
+	{
+	    size_ = 0;
+	}
+
+	iterator begin() noexcept
+	{
+	    return data_;
+	}
+
+	iterator end() noexcept
+	{
+	    return data_ + size_;
+	}
+
+	const_iterator begin() const noexcept
+	{
+	    return data_;
+	}
+
+	const_iterator end() const noexcept
+	{
+	    return data_ + size_;
+	}
+
+	const_iterator cbegin() const noexcept
+	{
+	    return data_;
+	}
+
+	const_iterator cend() const noexcept
+	{
+	    return data_ + size_;
+	}
+
+	T* data() noexcept
+	{
+	    return data_;
+	}
+
+	const T* data() const noexcept
+	{
+	    return data_;
+	}
+
+	reference back() noexcept
+	{
+	    return data_[size_ - 1];
+	}
+
+	const_reference back() const noexcept
+	{
+	    return data_[size_ - 1];
+	}
+
+	reference operator[](size_type position) noexcept
+	{
+	    return data_[position];
+	}
+
+	const_reference operator[](size_type position) const noexcept
+	{
+	    return data_[position];
+	}
+
+	bool empty() const noexcept
+	{
+	    return size_ == 0;
+	}
+
+	size_type size() const noexcept
+	{
+	    return size_;
+	}
+
+	size_type capacity() const noexcept
+	{
+	    return capacity_;
+	}
+
+	bool is_inline() const noexcept
+	{
+	    return data_ == buffer.data();
+	}
+
+	allocator_type get_allocator() const noexcept
+	{
+	    return allocator_;
+	}
+
+    private:
+
+	void reallocate(size_type capacity)
+	{
+	    T* data = traits::allocate(allocator_, capacity);
+
+	    std::copy(begin(), end(), data);
+
+	    release();
+
+	    data_     = data;
+	    capacity_ = capacity;
+	}
+
+	void release() noexcept
+	{
+	    if (not is_inline())
+	    {
+		traits::deallocate(allocator_, data_, capacity_);
+
+		data_     = buffer.data();
+		capacity_ = N;
+	    }
+	}
+
+	std::array<T, N> buffer {};
+
+	T*        data_     = buffer.data();
+	size_type size_     = 0;
+	size_type capacity_ = N;
+
+	[[no_unique_address]] allocator_type allocator_;
+    };
+}
@@ -1,13 +1,21 @@
 #pragma once
 
 #include <string_view>
+#include <functional>
 #include <algorithm>
 #include <stdexcept>
 #include <optional>
 #include <utility>
+#include <cstddef>
+#include <memory_resource>
+#include <memory>
 #include <vector>
+#include <span>
 
+#include "shared_dictionary.hpp"
+#include "parse_stats.hpp"
 #include "dictionary.hpp"
+#include "grammar.hpp"
 #include "option.hpp"
 #include "parser.hpp"
 
@@ -17,45 +25,102 @@ namespace cli::core
     {
     public:
 
+	using allocator_type  = std::pmr::polymorphic_allocator<>;
 	using key_type        = std::string_view;
-	using mapped_type     = std::vector<std::string_view>;
+	using mapped_type     = std::pmr::vector<std::string_view>;
 	using value_type      = std::pair<key_type, mapped_type>;
 	using reference       = value_type&;
 	using const_reference = const value_type&;
 
+	using stats_hook_type = std::function<void(const parse_stats&)>;
+
 	option_map() = default;
 
-	option_map(std::initializer_list<dictionary> ilist) :
-	    dictionaries {ilist}
+	explicit option_map(const allocator_type& allocator) noexcept :
+	    dictionaries (allocator),
+	    map          (allocator),
+	    ids          (allocator)
+	{}
+
+	option_map(std::initializer_list<dictionary> ilist,
+		   const allocator_type& allocator = {}) :
+	    dictionaries (ilist.begin(), ilist.end(), allocator),
+	    compiled     {grammar::compile(dictionaries)},
+	    map          (allocator),
+	    ids          (allocator)
 	{}
 
 	option_map(const option_map&) = default;
 
-	option_map(option_map&& other) noexcept :
-	    dictionaries {std::move(other.dictionaries)},
-	    map          {std::move(other.map)}
+	option_map(const option_map& other, const allocator_type& allocator) :
+	    dictionaries (other.dictionaries, allocator),
+	    compiled     {other.compiled},
+	    map          (other.map, allocator),
+	    ids          (other.ids, allocator),
+	    stats_       {other.stats_},
+	    stats_hook_  {other.stats_hook_}
 	{}
 
+	option_map(option_map&& other) noexcept :
+	    dictionaries (std::move(other.dictionaries)),
+	    compiled     {std::move(other.compiled)},
+	    map          (std::move(other.map)),
+	    ids          (std::move(other.ids)),
+	    stats_       {other.stats_},
+	    stats_hook_  {std::move(other.stats_hook_)}
+	{
+	    other.compiled = grammar::compile({});
+	}
+
 	option_map& operator=(const option_map&) = default;
 
-	option_map& operator=(option_map&& other) noexcept
+	// pmr allocators do not propagate, so storage from another memory
+	// resource cannot be taken over and is copied instead.
+	option_map& operator=(option_map&& other)
 	{
-	    if (this != &other)
+	    if (this == &other)
+	    {
+		return *this;
+	    }
+
+	    if (get_allocator() != other.get_allocator())
 	    {
-		std::swap(dictionaries, other.dictionaries);
-		std::swap(map,          other.map);
+		return *this = other;
 	    }
 
+	    dictionaries = std::move(other.dictionaries);
+	    compiled     = std::move(other.compiled);
+	    map          = std::move(other.map);
+	    ids          = std::move(other.ids);
+	    stats_       = other.stats_;
+	    stats_hook_  = std::move(other.stats_hook_);
+
+	    other.dictionaries.clear();
+	    other.map.clear();
+	    other.ids.clear();
+
+	    other.compiled = grammar::compile({});
+
 	    return *this;
 	}
 
-	void add_command_line_options(const parser::parsed_command_line&);
+	// Takes the options of any basic_parser configuration. A span
+	// starting with an argument rather than an option name raises
+	// argument_without_option and leaves the map unchanged.
+	void add_command_line_options(std::span<const std::string_view>);
+
+	allocator_type get_allocator() const noexcept
+	{
+	    return map.get_allocator();
+	}
 
 	void add_dictionary(const dictionary& dictionary)
 	{
 	    if (not (dictionary.empty() || contains(dictionary)))
 	    {
 		dictionaries.emplace_back(dictionary);
+
+		compiled = grammar::compile(dictionaries);
 	    }
 	}
 
@@ -64,10 +129,43 @@ namespace cli::core
 	    if (not (dictionary.empty() || contains(dictionary)))
 	    {
 		dictionaries.emplace_back(std::move(dictionary));
+
+		compiled = grammar::compile(dictionaries);
+	    }
+	}
+
+	void add_dictionary(const shared_dictionary& dictionary)
+	{
+	    if (not (dictionary.empty() || contains(dictionary)))
+	    {
+		dictionaries.emplace_back(dictionary);
+
+		compiled = grammar::compile(dictionaries);
 	    }
 	}
 
 	bool contains(const dictionary& dictionary) const noexcept
+	{
+	    if (not dictionary.empty())
+	    {
+		auto fingerprint = shared_dictionary::fingerprint(dictionary);
+
+		auto iterator = std::find_if(
+                    dictionaries.cbegin(),
+		    dictionaries.cend(),
+		    [&](auto&& shared_dictionary)
+		    {
+			return (shared_dictionary.fingerprint() == fingerprint &&
+				shared_dictionary == dictionary);
+		    });
+
+		return iterator != dictionaries.cend();
+	    }
+
+	    return false;
+	}
+
+	bool contains(const shared_dictionary& dictionary) const noexcept
 	{
 	    if (not dictionary.empty())
 	    {
@@ -105,11 +203,49 @@ namespace cli::core
 	    return dictionaries.empty();
 	}
 
+	// The grammar ids of options present in only one of the maps or
+	// with other arguments, in ascending order. Both maps are expected
+	// to share their dictionaries.
+	std::vector<grammar::size_type>
+	changed_options(const option_map&) const;
+
+	const parse_stats& stats() const noexcept
+	{
+	    return stats_;
+	}
+
+	void stats_hook(stats_hook_type hook)
+	{
+	    stats_hook_ = std::move(hook);
+	}
+
+	static mapped_type
+	split_arguments(std::string_view, const allocator_type& = {});
+
     private:
 
-	void add_option(std::string_view);
+	friend class canonical_argv;
+	friend class option_snapshot;
+
+	std::size_t add_option(std::string_view);
+
+	// The position of the entry for an option of the grammar, or for
+	// the unknown option named key, or ids.size().
+	std::size_t
+	find_entry(grammar::size_type id, std::string_view key) const noexcept
+	{
+	    for (std::size_t i = 0; i < ids.size(); ++i)
+	    {
+		if (ids[i] == id && (id != grammar::npos || map[i].first == key))
+		{
+		    return i;
+		}
+	    }
+
+	    return ids.size();
+	}
 
-	void add_option_argument(std::string_view, std::string_view);
+	void add_option_argument(std::size_t, std::string_view);
 
 	bool
 	dictionary_contains_option(const option& option) const noexcept
@@ -120,11 +256,10 @@ namespace cli::core
 	bool
 	dictionary_contains_option(std::string_view option_name) const noexcept
 	{
-	    return (find_option_in_dictionary(option_name) !=
-		    dictionaries.cend());
+	    return compiled->find(option_name) != grammar::npos;
 	}
 
-	std::vector<dictionary>::const_iterator
+	std::pmr::vector<shared_dictionary>::const_iterator
 	find_option_in_dictionary(const option& option) const noexcept
 	{
 	    return std::find_if(
@@ -136,69 +271,69 @@ namespace cli::core
 		});
 	}
 
-	std::vector<dictionary>::const_iterator
-	find_option_in_dictionary(std::string_view option_name) const noexcept
-	{
-	    return std::find_if(
-                dictionaries.cbegin(),
-		dictionaries.cend(),
-		[&](auto&& dictionary)
-		{
-		    return dictionary.contains(option_name);
-		});
-	}
-
-	std::vector<value_type>::const_iterator
+	std::pmr::vector<value_type>::const_iterator
 	find_option_in_map(const option& option) const noexcept
 	{
-	    return std::find_if(map.cbegin(), map.cend(), [&](auto&& value)
+	    auto iterator = std::find_if(ids.cbegin(), ids.cend(), [&](auto id)
 	    {
-		return option == value.first;
+		return id < compiled->size() && (*compiled)[id] == option;
 	    });
+
+	    return map.cbegin() + (iterator - ids.cbegin());
 	}
 
-	std::vector<value_type>::const_iterator
+	std::pmr::vector<value_type>::const_iterator
 	find_option_in_map(std::string_view option_name) const noexcept
 	{
-	    if (dictionary_contains_option(option_name))
+	    if (auto id = compiled->find(option_name); id != grammar::npos)
 	    {
-		auto& option = get_option_from_dictionary(option_name);
+		auto iterator = std::find(ids.cbegin(), ids.cend(), id);
 
-		return std::find_if(map.cbegin(), map.cend(), [&](auto&& value)
-		{
-		    return option == value.first;
-		});
+		return map.cbegin() + (iterator - ids.cbegin());
 	    }
 
 	    return map.cend();
 	}
 
-	const mapped_type&
-	get_option_arguments(std::string_view option_name) const noexcept
+	const option&
+	get_option_from_dictionary(std::string_view option_name) const noexcept
 	{
-	    return find_option_in_map(option_name)->second;
+	    return (*compiled)[compiled->find(option_name)];
 	}
 
-	mapped_type&
-	get_option_arguments(std::string_view option_name) noexcept
+	template<typename Function>
+	static void
+	for_each_argument(std::string_view option_argument, Function&& function)
 	{
-	    using const_this = const option_map*;
+	    for (std::size_t i = 0, size = option_argument.size(); i < size; ++i)
+	    {
+		while (i < size && option_argument[i] == ',')
+		{
+		    ++i;
+		}
 
-	    auto& arguments =
-		const_cast<const_this>(this)->get_option_arguments(option_name);
+		std::size_t first = i++;
 
-	    return const_cast<mapped_type&>(arguments);
-	}
+		while (i < size && option_argument[i] != ',')
+		{
+		    ++i;
+		}
 
-	const option&
-	get_option_from_dictionary(std::string_view option_name) const noexcept
-	{
-	    return (*find_option_in_dictionary(option_name))[option_name];
+		if (first < size)
+		{
+		    function(option_argument.substr(first, i - first));
+		}
+	    }
 	}
 
-	static std::vector<std::string_view> split_arguments(std::string_view);
+	std::pmr::vector<shared_dictionary> dictionaries;
+
+	std::shared_ptr<const grammar> compiled = grammar::compile({});
+
+	std::pmr::vector<value_type>         map;
+	std::pmr::vector<grammar::size_type> ids;
 
-	std::vector<dictionary> dictionaries;
-	std::vector<value_type> map;
+	[[no_unique_address]] stats_storage      stats_;
+	[[no_unique_address]] stats_hook_storage stats_hook_;
     };
 }
@@ -0,0 +1,241 @@
+#pragma once
+
+#include <initializer_list>
+#include <string_view>
+#include <iterator>
+#include <optional>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include <span>
+
+#include "core/option_map.hpp"
+#include "core/dictionary.hpp"
+#include "core/grammar.hpp"
+#include "core/option.hpp"
+
+namespace cli::core
+{
+    // A read-only option_map over a blob written by option_snapshot::write.
+    // The blob holds option ids, presence bits and argument bytes at
+    // offsets from its start, so it can be sent to another process, read
+    // or mapped anywhere and used in place, without parsing or allocating.
+    //
+    // Layout, in host byte order:
+    //
+    //	header     magic, version, grammar fingerprint, option, entry,
+    //	           argument and byte counts
+    //	presence   one bit per grammar id, 64 ids per word
+    //	ranks      entries before each presence word
+    //	entries    id, key and arguments of each option, ordered by id
+    //	arguments  offset and size of each argument
+    //	bytes      keys and arguments
+    class option_snapshot final
+    {
+    public:
+
+	static constexpr std::uint32_t magic   = 0x534e4c43;
+	static constexpr std::uint32_t version = 1;
+
+	// The arguments of one option, viewed in the snapshot.
+	class argument_list final
+	{
+	public:
+
+	    class iterator final
+	    {
+	    public:
+
+		using iterator_category = std::forward_iterator_tag;
+		using value_type        = std::string_view;
+		using difference_type   = std::ptrdiff_t;
+		using pointer           = void;
+		using reference         = std::string_view;
+
+		iterator() = default;
+
+		std::string_view operator*() const noexcept
+		{
+		    return read_argument(record, bytes);
+		}
+
+		iterator& operator++() noexcept
+		{
+		    record += argument_record_size;
+
+		    return *this;
+		}
+
+		iterator operator++(int) noexcept
+		{
+		    auto copy = *this;
+
+		    ++*this;
+
+		    return copy;
+		}
+
+		friend bool operator==(const iterator& lhs,
+				       const iterator& rhs) noexcept
+		{
+		    return lhs.record == rhs.record;
+		}
+
+	    private:
+
+		friend argument_list;
+
+		iterator(const std::byte* record, const char* bytes) noexcept :
+		    record {record},
+		    bytes  {bytes}
+		{}
+
+		const std::byte* record = nullptr;
+		const char*      bytes  = nullptr;
+	    };
+
+	    argument_list() = default;
+
+	    iterator begin() const noexcept
+	    {
+		return {records, bytes};
+	    }
+
+	    iterator end() const noexcept
+	    {
+		return {records + size_ * argument_record_size, bytes};
+	    }
+
+	    bool empty() const noexcept
+	    {
+		return size_ == 0;
+	    }
+
+	    std::size_t size() const noexcept
+	    {
+		return size_;
+	    }
+
+	    std::string_view front() const noexcept
+	    {
+		return (*this)[0];
+	    }
+
+	    std::string_view back() const noexcept
+	    {
+		return (*this)[size_ - 1];
+	    }
+
+	    std::string_view operator[](std::size_t position) const noexcept
+	    {
+		return read_argument(
+		    records + position * argument_record_size, bytes);
+	    }
+
+	private:
+
+	    friend option_snapshot;
+
+	    argument_list(const std::byte* records,
+			  const char*      bytes,
+			  std::size_t      size) noexcept :
+		records {records},
+		bytes   {bytes},
+		size_   {size}
+	    {}
+
+	    const std::byte* records = nullptr;
+	    const char*      bytes   = nullptr;
+	    std::size_t      size_   = 0;
+	};
+
+	// The blob is checked against the grammar of the given dictionaries
+	// and must outlive the snapshot.
+	option_snapshot(std::span<const std::byte>,
+			std::initializer_list<dictionary>);
+
+	option_snapshot(std::span<const std::byte>, const option_map&);
+
+	static std::vector<std::byte> write(const option_map&);
+
+	bool contains(const option&) const noexcept;
+
+	std::optional<std::string_view>
+	contains(std::string_view) const noexcept;
+
+	argument_list operator[](const option&) const;
+
+	argument_list operator[](std::string_view) const;
+
+	bool empty() const noexcept
+	{
+	    return size_ == 0;
+	}
+
+	// The number of options present.
+	std::size_t size() const noexcept
+	{
+	    return size_;
+	}
+
+	std::uint64_t fingerprint() const noexcept
+	{
+	    return compiled->fingerprint();
+	}
+
+    private:
+
+	static constexpr std::size_t header_size          = 32;
+	static constexpr std::size_t entry_record_size    = 20;
+	static constexpr std::size_t argument_record_size = 8;
+
+	option_snapshot(std::span<const std::byte>,
+			std::shared_ptr<const grammar>);
+
+	template<typename T>
+	static T load(const std::byte* bytes) noexcept
+	{
+	    T value;
+
+	    std::memcpy(&value, bytes, sizeof(value));
+
+	    return value;
+	}
+
+	static std::string_view
+	read_argument(const std::byte* record, const char* bytes) noexcept
+	{
+	    return {
+		bytes + load<std::uint32_t>(record),
+		load<std::uint32_t>(record + 4)
+	    };
+	}
+
+	// The entry of id, or npos when it is absent.
+	std::size_t find_entry(grammar::size_type) const noexcept;
+
+	std::string_view key(std::size_t entry) const noexcept;
+
+	argument_list arguments(std::size_t entry) const noexcept;
+
+	argument_list
+	checked_arguments(grammar::size_type, std::string_view) const;
+
+	static constexpr std::size_t npos = -1;
+
+	std::span<const std::byte> blob;
+
+	std::shared_ptr<const grammar> compiled;
+
+	const std::byte* presence = nullptr;
+	const std::byte* ranks    = nullptr;
+	const std::byte* entries  = nullptr;
+	const std::byte* records  = nullptr;
+	const char*      bytes    = nullptr;
+
+	std::size_t words = 0;
+	std::size_t size_ = 0;
+    };
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <memory_resource>
+#include <string_view>
+#include <cstddef>
+#include <utility>
+#include <span>
+
+#include "core/arena_storage.hpp"
+#include "core/parser.hpp"
+
+namespace cli::core
+{
+    // The options and positional options of a parse, copied out of argv.
+    // The views and every byte they refer to share one allocation, so the
+    // command line can be freed and the result kept, moved to another
+    // thread or copied for the price of a single allocation. An option_map
+    // filled from options() refers into the same storage.
+    class owned_command_line final
+    {
+    public:
+
+	using allocator_type = std::pmr::polymorphic_allocator<>;
+
+	owned_command_line() = default;
+
+	explicit owned_command_line(const allocator_type& allocator) noexcept :
+	    storage {allocator}
+	{}
+
+	owned_command_line(std::span<const std::string_view> options,
+			   std::span<const std::string_view> positional_options,
+			   const allocator_type& = {});
+
+	template<
+	    typename LookupPolicy,
+	    typename StoragePolicy,
+	    typename ErrorPolicy,
+	    typename Allocator
+	>
+	explicit owned_command_line(
+	    const basic_parser<
+		LookupPolicy, StoragePolicy, ErrorPolicy, Allocator
+	    >& parser,
+	    const allocator_type& allocator = {})
+	    :
+	    owned_command_line {
+		std::span {
+		    parser.options().data(),
+		    parser.options().size()
+		},
+		std::span {
+		    parser.positional_options().data(),
+		    parser.positional_options().size()
+		},
+		allocator
+	    }
+	{}
+
+	owned_command_line(const owned_command_line& other) :
+	    owned_command_line {other, other.get_allocator()}
+	{}
+
+	owned_command_line(const owned_command_line& other,
+			   const allocator_type& allocator) :
+	    owned_command_line {other.options_, other.positional_, allocator}
+	{}
+
+	owned_command_line(owned_command_line&& other) noexcept :
+	    storage     {std::move(other.storage)},
+	    options_    {std::exchange(other.options_, {})},
+	    positional_ {std::exchange(other.positional_, {})}
+	{}
+
+	owned_command_line& operator=(const owned_command_line& other)
+	{
+	    if (this != &other)
+	    {
+		*this = owned_command_line {other, get_allocator()};
+	    }
+
+	    return *this;
+	}
+
+	owned_command_line& operator=(owned_command_line&&);
+
+	std::span<const std::string_view> options() const noexcept
+	{
+	    return options_;
+	}
+
+	std::span<const std::string_view> positional_options() const noexcept
+	{
+	    return positional_;
+	}
+
+	// Bytes held for views and the characters they refer to.
+	std::size_t arena_size() const noexcept
+	{
+	    return storage.size();
+	}
+
+	allocator_type get_allocator() const noexcept
+	{
+	    return storage.get_allocator();
+	}
+
+    private:
+
+	arena_storage storage;
+
+	std::span<const std::string_view> options_;
+	std::span<const std::string_view> positional_;
+    };
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <initializer_list>
+#include <unordered_map>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <list>
+#include <span>
+
+#include "core/option_map.hpp"
+#include "core/dictionary.hpp"
+#include "core/parser.hpp"
+
+namespace cli::core
+{
+    // A parsed command line that owns its tokens. Options and positional
+    // options refer into the stored bytes, so a result never moves.
+    class parse_result final
+    {
+    public:
+
+	parse_result(const parser&, const option_map&, int, const char**);
+
+	parse_result(const parse_result&) = delete;
+
+	parse_result& operator=(const parse_result&) = delete;
+
+	const option_map& options() const noexcept
+	{
+	    return options_;
+	}
+
+	std::span<const std::string_view> positional_options() const noexcept
+	{
+	    return positional_options_;
+	}
+
+	// Whether argv holds exactly the bytes this result was parsed from.
+	bool matches(int, const char**) const noexcept;
+
+	static std::uint64_t hash(int, const char**) noexcept;
+
+    private:
+
+	// The tokens, each followed by a null character.
+	std::string bytes;
+
+	int argc;
+
+	option_map options_;
+
+	std::vector<std::string_view> positional_options_;
+    };
+
+    // Parses command lines through a bounded cache of results, keyed by a
+    // hash of the argv bytes and evicting the least recently used entry.
+    // Hits are checked byte for byte, so a hash collision is re-parsed
+    // rather than answered with another command line's options.
+    class parse_cache final
+    {
+    public:
+
+	struct statistics final
+	{
+	    std::size_t hits       = 0;
+	    std::size_t misses     = 0;
+	    std::size_t evictions  = 0;
+	    std::size_t collisions = 0;
+
+	    double hit_rate() const noexcept
+	    {
+		auto lookups = hits + misses;
+
+		return lookups ? static_cast<double>(hits) / lookups : 0.0;
+	    }
+	};
+
+	parse_cache(std::initializer_list<dictionary>, std::size_t capacity);
+
+	// Parse errors are raised as parser raises them and never cached.
+	std::shared_ptr<const parse_result> parse(int, const char**);
+
+	std::shared_ptr<const parse_result> parse(int argc, char** argv)
+	{
+	    return parse(argc, const_cast<const char**>(argv));
+	}
+
+	statistics stats() const
+	{
+	    std::scoped_lock lock {mutex};
+
+	    return stats_;
+	}
+
+	std::size_t size() const
+	{
+	    std::scoped_lock lock {mutex};
+
+	    return entries.size();
+	}
+
+	std::size_t capacity() const noexcept
+	{
+	    return capacity_;
+	}
+
+	void clear();
+
+    private:
+
+	struct entry final
+	{
+	    std::uint64_t                       hash;
+	    std::shared_ptr<const parse_result> result;
+	};
+
+	using entry_list = std::list<entry>;
+
+	const parser     parser_prototype;
+	const option_map map_prototype;
+
+	std::size_t capacity_;
+
+	mutable std::mutex mutex;
+
+	entry_list entries;
+
+	std::unordered_map<std::uint64_t, entry_list::iterator> index;
+
+	statistics stats_;
+    };
+}
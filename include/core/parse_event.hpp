@@ -0,0 +1,24 @@
+#pragma once
+
+#include <string_view>
+
+#include "option.hpp"
+
+namespace cli::core
+{
+    struct parse_event final
+    {
+	enum class kind
+	{
+	    option = 0,
+	    argument,
+	    positional,
+	    pass_through
+	};
+
+	kind                type   = kind::positional;
+	int                 index  = 0;
+	const core::option* option = nullptr;
+	std::string_view    value;
+    };
+}
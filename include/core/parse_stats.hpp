@@ -0,0 +1,87 @@
+#pragma once
+
+#include <functional>
+#include <cstdint>
+#include <chrono>
+
+#include "configuration/instrumentation.hpp"
+
+namespace cli::core
+{
+    struct parse_stats final
+    {
+	using duration = std::chrono::nanoseconds;
+
+	std::uint64_t tokens          = 0;
+	std::uint64_t lookups         = 0;
+	std::uint64_t comparisons     = 0;
+	std::uint64_t validator_calls = 0;
+
+	// A heuristic, not a count: see estimate_allocation.
+	std::uint64_t estimated_allocations = 0;
+
+	duration tokenize       {};
+	duration resolve        {};
+	duration required_check {};
+	duration map_build      {};
+
+	// Counts an allocation when the next insertion into container finds
+	// it full. This guesses a growing vector; insertions into reserved,
+	// inline or node based storage are miscounted, and nothing is known of
+	// what the allocator behind the container does.
+	template<typename Container>
+	void estimate_allocation(const Container& container) noexcept
+	{
+	    estimated_allocations += container.size() == container.capacity();
+	}
+
+	parse_stats& operator+=(const parse_stats& other) noexcept
+	{
+	    tokens          += other.tokens;
+	    lookups         += other.lookups;
+	    comparisons     += other.comparisons;
+	    validator_calls += other.validator_calls;
+	    estimated_allocations += other.estimated_allocations;
+
+	    tokenize       += other.tokenize;
+	    resolve        += other.resolve;
+	    required_check += other.required_check;
+	    map_build      += other.map_build;
+
+	    return *this;
+	}
+    };
+
+    // What a parser or option_map keeps of its statistics and its hook.
+    // Compiled without instrumentation both are empty types, so their
+    // [[no_unique_address]] members take no space; the statistics read
+    // as zero and a hook handed over is dropped.
+#if INSTRUMENTATION_ENABLED
+
+    using stats_storage = parse_stats;
+
+    using stats_hook_storage = std::function<void(const parse_stats&)>;
+
+#else
+
+    struct stats_storage final
+    {
+	operator const parse_stats&() const noexcept
+	{
+	    static constexpr parse_stats none;
+
+	    return none;
+	}
+    };
+
+    struct stats_hook_storage final
+    {
+	stats_hook_storage() = default;
+
+	template<typename Hook>
+	stats_hook_storage(Hook&&) noexcept
+	{}
+    };
+
+#endif
+}
@@ -2,27 +2,85 @@
 
 #include <initializer_list>
 #include <string_view>
+#include <functional>
 #include <algorithm>
 #include <optional>
+#include <iterator>
 #include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <chrono>
+#include <memory_resource>
+#include <memory>
 #include <vector>
+#include <array>
+#include <span>
 
+#include "configuration/exception_source_information.hpp"
+#include "configuration/instrumentation.hpp"
+#include "configuration/tracing.hpp"
+
+#include "core/shared_dictionary.hpp"
+#include "core/parser_policies.hpp"
+#include "core/parse_stats.hpp"
+#include "core/parse_event.hpp"
+#include "core/diagnostic.hpp"
 #include "core/dictionary.hpp"
+#include "core/grammar.hpp"
 #include "core/option.hpp"
 
+#include "error/option_is_required_but_not_added.hpp"
+#include "error/option_already_added_as.hpp"
+#include "error/option_expects_argument.hpp"
+#include "error/unrecognized_option.hpp"
+#include "error/ambiguous_option.hpp"
+
 namespace cli::core
 {
-    class parser final
+    // The parser's hot path specialized at compile time: LookupPolicy
+    // picks how option names are resolved, StoragePolicy where parsed
+    // tokens are kept, ErrorPolicy what a parse error does and Allocator
+    // where everything the parser owns is allocated. parser below is the
+    // configuration used everywhere else in the library.
+    template<
+	typename LookupPolicy,
+	typename StoragePolicy,
+	typename ErrorPolicy,
+	typename Allocator
+    >
+    class basic_parser final
     {
+	template<typename T>
+	using vector_type = std::vector<
+	    T,
+	    typename std::allocator_traits<Allocator>::template rebind_alloc<T>
+	>;
+
     public:
 
-	class parsed_command_line final : private std::vector<std::string_view>
+	using allocator_type = Allocator;
+
+	using error_policy = ErrorPolicy;
+
+	using result_type = typename ErrorPolicy::result_type;
+
+	template<typename T>
+	using container_type =
+	    typename StoragePolicy::template container<T, Allocator>;
+
+	using stats_hook_type = std::function<void(const parse_stats&)>;
+
+	// A run of consecutive argv entries passed through unparsed.
+	using pass_through_type = std::span<const char* const>;
+
+	class parsed_command_line final
+	    : private container_type<std::string_view>
 	{
 	public:
 
-	    friend parser;
+	    friend basic_parser;
 
-	    using container = std::vector<std::string_view>;
+	    using container = container_type<std::string_view>;
 
 	    using value_type      = container::value_type;
 	    using reference       = container::reference;
@@ -41,6 +99,11 @@ namespace cli::core
 		return container::cend();
 	    }
 
+	    const value_type* data() const noexcept
+	    {
+		return container::data();
+	    }
+
 	    const_iterator begin() const noexcept
 	    {
 		return container::begin();
@@ -56,6 +119,11 @@ namespace cli::core
 		return container::empty();
 	    }
 
+	    allocator_type get_allocator() const noexcept
+	    {
+		return container::get_allocator();
+	    }
+
 	    size_type size() const noexcept
 	    {
 		return container::size();
@@ -69,45 +137,312 @@ namespace cli::core
 	private:
 
 	    parsed_command_line() = default;
+
+	    explicit parsed_command_line(const allocator_type& allocator) noexcept :
+		container (allocator)
+	    {}
+
+	    parsed_command_line(const parsed_command_line& other,
+				const allocator_type& allocator) :
+		container (other, allocator)
+	    {}
+	};
+
+    private:
+
+	struct parse_state final
+	{
+	    int          argc;
+	    const char** argv;
+	    int          index = 1;
+
+	    parse_event pending_argument {};
+	    bool        has_pending_argument = false;
+
+	    // Set by an unrecognized option in pass-through mode, so the
+	    // tokens following it are passed through as well.
+	    bool passing_through = false;
+	};
+
+    public:
+
+	class event_range final
+	{
+	public:
+
+	    class iterator final
+	    {
+	    public:
+
+		using value_type      = parse_event;
+		using reference       = const parse_event&;
+		using pointer         = const parse_event*;
+		using difference_type = std::ptrdiff_t;
+
+		iterator() = default;
+
+		reference operator*() const noexcept
+		{
+		    return range->event;
+		}
+
+		pointer operator->() const noexcept
+		{
+		    return &range->event;
+		}
+
+		iterator& operator++()
+		{
+		    range->advance();
+
+		    return *this;
+		}
+
+		void operator++(int)
+		{
+		    range->advance();
+		}
+
+		friend bool
+		operator==(const iterator& it, std::default_sentinel_t) noexcept
+		{
+		    return it.done();
+		}
+
+	    private:
+
+		friend event_range;
+
+		explicit iterator(event_range* range) noexcept :
+		    range {range}
+		{}
+
+		bool done() const noexcept
+		{
+		    return range->done;
+		}
+
+		event_range* range = nullptr;
+	    };
+
+	    event_range(event_range&&) = default;
+
+	    event_range& operator=(event_range&&) = default;
+
+	    iterator begin()
+	    {
+		if (not started)
+		{
+		    started = true;
+
+		    INSTRUMENT(parser_->stats_ = {};)
+
+		    TRACEPOINT(parse__start, state.argc);
+
+		    parser_->errors_.reset();
+
+		    std::fill(
+			parser_->presence.begin(),
+			parser_->presence.end(),
+			0);
+
+		    advance();
+		}
+
+		return iterator {this};
+	    }
+
+	    std::default_sentinel_t end() const noexcept
+	    {
+		return {};
+	    }
+
+	    void check_required_options()
+	    {
+		for (auto it = begin(); it != end(); ++it)
+		{}
+
+		if (not parser_->errors_.stopped())
+		{
+		    parser_->check_required_options();
+		}
+	    }
+
+	private:
+
+	    friend basic_parser;
+
+	    event_range(basic_parser& parser, int argc, const char** argv) noexcept :
+		parser_ {&parser},
+		state   {argc, argv}
+	    {}
+
+	    void advance()
+	    {
+		done = not parser_->next_event(state, event);
+
+		if (done)
+		{
+		    TRACEPOINT(parse__end, state.argc);
+		}
+	    }
+
+	    basic_parser* parser_;
+	    parse_state   state;
+	    parse_event   event;
+
+	    bool started = false;
+	    bool done    = false;
 	};
 
-	parser() = default;
+	basic_parser() = default;
+
+	explicit basic_parser(const allocator_type& allocator) noexcept :
+	    dictionaries        (allocator),
+	    presence            (allocator),
+	    options_            (allocator),
+	    positional_options_ (allocator),
+	    pass_through_       (allocator)
+	{}
 
-	parser(std::initializer_list<dictionary> dictionaries)
+	basic_parser(std::initializer_list<dictionary> dictionaries,
+		     const allocator_type& allocator = {}) :
+	    basic_parser {allocator}
 	{
 	    for (auto&& dictionary : dictionaries)
 	    {
-		add_dictionary(dictionary);
+		if (not contains(dictionary))
+		{
+		    this->dictionaries.emplace_back(dictionary);
+		}
 	    }
+
+	    compile();
 	}
 
-	parser(const parser&) = default;
+	basic_parser(const basic_parser&) = default;
+
+	basic_parser(const basic_parser& other, const allocator_type& allocator) :
+	    dictionaries        (other.dictionaries, allocator),
+	    compiled            {other.compiled},
+	    presence            (other.presence, allocator),
+	    options_            (other.options_, allocator),
+	    positional_options_ (other.positional_options_, allocator),
+	    pass_through_       (other.pass_through_, allocator),
+	    abbreviations_      {other.abbreviations_},
+	    passes_through_     {other.passes_through_},
+	    strategy_           {other.strategy_},
+	    stats_              {other.stats_},
+	    errors_             {other.errors_},
+	    stats_hook_         {other.stats_hook_}
+	{}
 
-	parser(parser&& other) noexcept :
-	    parser {}
+	basic_parser(basic_parser&& other) noexcept :
+	    dictionaries        (std::move(other.dictionaries)),
+	    compiled            {std::move(other.compiled)},
+	    presence            (std::move(other.presence)),
+	    options_            (std::move(other.options_)),
+	    positional_options_ (std::move(other.positional_options_)),
+	    pass_through_       (std::move(other.pass_through_)),
+	    abbreviations_      {other.abbreviations_},
+	    passes_through_     {other.passes_through_},
+	    strategy_           {other.strategy_},
+	    stats_              {other.stats_},
+	    errors_             {std::move(other.errors_)},
+	    stats_hook_         {std::move(other.stats_hook_)}
 	{
-	    this->operator=(std::move(other));
+	    other.compiled = grammar::compile({});
 	}
 
-	parser& operator=(const parser&) = default;
+	basic_parser& operator=(const basic_parser&) = default;
 
-	parser& operator=(parser&& other) noexcept
+	// pmr allocators do not propagate, so storage from another memory
+	// resource cannot be taken over and is copied instead.
+	basic_parser& operator=(basic_parser&& other) noexcept(
+	    std::allocator_traits<Allocator>::is_always_equal::value)
 	{
-	    if (this != &other)
+	    if (this == &other)
 	    {
-		std::swap(dictionaries,        other.dictionaries);
-		std::swap(options_,            other.options_);
-		std::swap(positional_options_, other.positional_options_);
+		return *this;
 	    }
 
+	    if (get_allocator() != other.get_allocator())
+	    {
+		return *this = other;
+	    }
+
+	    dictionaries        = std::move(other.dictionaries);
+	    compiled            = std::move(other.compiled);
+	    presence            = std::move(other.presence);
+	    options_            = std::move(other.options_);
+	    positional_options_ = std::move(other.positional_options_);
+	    pass_through_       = std::move(other.pass_through_);
+	    abbreviations_      = other.abbreviations_;
+	    passes_through_     = other.passes_through_;
+	    strategy_           = other.strategy_;
+	    stats_              = other.stats_;
+	    errors_             = std::move(other.errors_);
+	    stats_hook_         = std::move(other.stats_hook_);
+
+	    other.dictionaries.clear();
+	    other.presence.clear();
+	    other.options_.clear();
+	    other.positional_options_.clear();
+	    other.pass_through_.clear();
+
+	    other.compiled = grammar::compile({});
+
 	    return *this;
 	}
 
+	bool abbreviations() const noexcept
+	{
+	    return abbreviations_;
+	}
+
+	void abbreviations(bool enabled) noexcept
+	{
+	    abbreviations_ = enabled;
+	}
+
+	// In pass-through mode an unrecognized option is no error: it and
+	// the tokens up to the next option of the grammar are reported as
+	// pass_through events and kept in pass_through(), for a wrapper to
+	// hand them to the program it runs.
+	bool passes_through() const noexcept
+	{
+	    return passes_through_;
+	}
+
+	void passes_through(bool enabled) noexcept
+	{
+	    passes_through_ = enabled;
+	}
+
+	// The strategy actually used for long option names; automatic is
+	// resolved when the grammar is compiled.
+	grammar::lookup_strategy lookup_strategy() const noexcept
+	{
+	    return compiled->strategy();
+	}
+
+	void lookup_strategy(grammar::lookup_strategy strategy)
+	{
+	    if (strategy != strategy_)
+	    {
+		strategy_ = strategy;
+
+		compile();
+	    }
+	}
+
 	void add_dictionary(const dictionary& dictionary)
 	{
 	    if (not contains(dictionary))
 	    {
 		dictionaries.emplace_back(dictionary);
+
+		compile();
 	    }
 	}
 
@@ -116,12 +451,26 @@ namespace cli::core
 	    if (not contains(dictionary))
 	    {
 		dictionaries.emplace_back(std::move(dictionary));
+
+		compile();
+	    }
+	}
+
+	void add_dictionary(const shared_dictionary& dictionary)
+	{
+	    if (not contains(dictionary))
+	    {
+		dictionaries.emplace_back(dictionary);
+
+		compile();
 	    }
 	}
 
 	void clear() noexcept
 	{
 	    dictionaries.clear();
+
+	    compile();
 	}
 
 	std::optional<std::string_view>
@@ -139,6 +488,22 @@ namespace cli::core
 	}
 
 	bool contains(const dictionary& dictionary) const noexcept
+	{
+	    auto fingerprint = shared_dictionary::fingerprint(dictionary);
+
+	    auto iterator = std::find_if(
+                dictionaries.cbegin(),
+		dictionaries.cend(),
+		[&](auto&& shared_dictionary)
+		{
+		    return (shared_dictionary.fingerprint() == fingerprint &&
+			    shared_dictionary == dictionary);
+		});
+
+	    return iterator != dictionaries.cend();
+	}
+
+	bool contains(const shared_dictionary& dictionary) const noexcept
 	{
 	    auto iterator = std::find(
                 dictionaries.cbegin(), dictionaries.cend(), dictionary);
@@ -165,6 +530,8 @@ namespace cli::core
                 dictionaries.begin(), dictionaries.end(), dictionary);
 
 	    dictionaries.erase(iterator, dictionaries.end());
+
+	    compile();
 	}
 
 	bool empty() const noexcept
@@ -172,58 +539,766 @@ namespace cli::core
 	    return dictionaries.empty();
 	}
 
+	const error_policy& errors() const noexcept
+	{
+	    return errors_;
+	}
+
+	allocator_type get_allocator() const noexcept
+	{
+	    return options_.get_allocator();
+	}
+
+	event_range events(int argc, const char** argv) noexcept
+	{
+	    return event_range {*this, argc, argv};
+	}
+
+	event_range events(int argc, char** argv) noexcept
+	{
+	    return events(argc, const_cast<const char**>(argv));
+	}
+
 	const parsed_command_line& options() const noexcept
 	{
 	    return options_;
 	}
 
-	void parse_command_line(int, const char**);
+	result_type parse_command_line(int, const char**);
 
-	void parse_command_line(int argc, char** argv)
+	result_type parse_command_line(int argc, char** argv)
 	{
-	    parse_command_line(argc, const_cast<const char**>(argv));
+	    return parse_command_line(argc, const_cast<const char**>(argv));
 	}
 
-	const std::vector<std::string_view>& positional_options() const noexcept
+	template<typename Handler>
+	result_type
+	parse_command_line(int argc, const char** argv, Handler&& handler)
+	{
+	    INSTRUMENT(
+		stats_ = {};
+
+		auto start = std::chrono::steady_clock::now();
+	    )
+
+	    TRACEPOINT(parse__start, argc);
+
+	    errors_.reset();
+
+	    parse_state state {argc, argv};
+
+	    parse_event event;
+
+	    std::fill(presence.begin(), presence.end(), 0);
+
+	    while (next_event(state, event))
+	    {
+		handler(std::as_const(event));
+	    }
+
+	    if (not errors_.stopped())
+	    {
+		check_required_options();
+	    }
+
+	    TRACEPOINT(parse__end, argc);
+
+	    INSTRUMENT(publish_stats(std::chrono::steady_clock::now() - start);)
+
+	    return errors_.result();
+	}
+
+	template<typename Handler>
+	result_type
+	parse_command_line(int argc, char** argv, Handler&& handler)
+	{
+	    return parse_command_line(
+		argc,
+		const_cast<const char**>(argv),
+		std::forward<Handler>(handler));
+	}
+
+	const container_type<std::string_view>&
+	positional_options() const noexcept
 	{
 	    return positional_options_;
 	}
 
+	// The tokens passed through by the last parse_command_line, as runs
+	// of argv in command line order; nothing is copied, so they refer
+	// into argv.
+	const container_type<pass_through_type>& pass_through() const noexcept
+	{
+	    return pass_through_;
+	}
+
+	// Checks a command line the way parse_command_line would, without
+	// storing anything, and returns the diagnostic of the first error.
+	// Presence is tracked on the stack, validate_window options at a
+	// time, so nothing is allocated however large the grammar is.
+	std::optional<diagnostic> validate(int, const char**) const noexcept;
+
+	std::optional<diagnostic> validate(int argc, char** argv) const noexcept
+	{
+	    return validate(argc, const_cast<const char**>(argv));
+	}
+
+	const parse_stats& stats() const noexcept
+	{
+	    return stats_;
+	}
+
+	void stats_hook(stats_hook_type hook)
+	{
+	    stats_hook_ = std::move(hook);
+	}
+
+	static constexpr std::size_t validate_window = 1024;
+
     private:
 
-	void add_option(std::string_view);
+	// What resolve_option returns for an option to pass through.
+	static constexpr grammar::size_type unrecognized = grammar::npos - 2;
+
+	// Every parse error passes here, so the parse__error probe fires
+	// whether the policy then throws, stops or keeps collecting.
+	template<typename MakeError>
+	void raise_error(const diagnostic& diagnostic, MakeError&& make_error)
+	{
+	    TRACEPOINT(parse__error,
+		       static_cast<int>(diagnostic.type),
+		       diagnostic.index,
+		       diagnostic.id);
+
+	    errors_.raise(diagnostic, std::forward<MakeError>(make_error));
+	}
+
+	void check_required_options();
+
+	bool next_event(parse_state&, parse_event&);
+
+	grammar::size_type resolve_option(const parse_state&, std::string_view);
 
-	bool dictionary_contains(std::string_view option_name) const noexcept
+	void compile()
 	{
-	    return (find_option_in_dictionary(option_name) !=
-		    dictionaries.cend());
+	    compiled = grammar::compile(dictionaries, strategy_);
+
+	    presence.assign((compiled->size() + 63) / 64, 0);
 	}
 
-	std::vector<dictionary>::const_iterator
-	find_option_in_dictionary(std::string_view option_name) const noexcept
+	grammar::size_type
+	find_option(std::string_view option_name,
+		    parse_stats*     stats = nullptr) const noexcept
 	{
-	    return std::find_if(
-                dictionaries.cbegin(),
-		dictionaries.cend(),
-		[&](auto&& dictionary)
+	    constexpr auto strategy = LookupPolicy::strategy;
+
+	    // The grammar of a moved-from parser, or of one given another
+	    // strategy at run time, is looked up as its strategy says.
+	    if (compiled->strategy() == strategy)
+	    {
+		if (abbreviations_)
 		{
-		    return dictionary.contains(option_name);
-		});
+		    return compiled->template find_abbreviated<strategy>(
+			option_name, stats);
+		}
+
+		return compiled->template find<strategy>(option_name, stats);
+	    }
+
+	    if (abbreviations_)
+	    {
+		return compiled->find_abbreviated(option_name, stats);
+	    }
+
+	    return compiled->find(option_name, stats);
 	}
 
-	std::vector<std::string_view>::const_iterator
+	void publish_stats(parse_stats::duration);
+
+	typename parsed_command_line::const_iterator
 	find_option_with_validation(std::string_view) const noexcept;
 
-	const option&
-	get_option_from_dictionary(std::string_view option_name) const noexcept
+	vector_type<shared_dictionary> dictionaries;
+
+	std::shared_ptr<const grammar> compiled = grammar::compile({});
+	vector_type<std::uint64_t>     presence;
+
+	parsed_command_line              options_;
+	container_type<std::string_view> positional_options_;
+
+	container_type<pass_through_type> pass_through_;
+
+	bool abbreviations_  = false;
+	bool passes_through_ = false;
+
+	grammar::lookup_strategy strategy_ = LookupPolicy::strategy;
+
+	[[no_unique_address]] stats_storage stats_;
+
+	[[no_unique_address]] error_policy errors_;
+
+	[[no_unique_address]] stats_hook_storage stats_hook_;
+    };
+
+
+    template<
+	typename LookupPolicy,
+	typename StoragePolicy,
+	typename ErrorPolicy,
+	typename Allocator
+    >
+    auto
+    basic_parser<LookupPolicy, StoragePolicy, ErrorPolicy, Allocator>::
+    parse_command_line(int argc, const char** argv) -> result_type
+    {
+	options_.clear();
+
+	positional_options_.clear();
+
+	pass_through_.clear();
+
+	INSTRUMENT(
+	    const typename parsed_command_line::container& options = options_;
+	)
+
+	return parse_command_line(argc, argv, [&](const parse_event& event)
+	{
+	    switch (event.type)
+	    {
+	    case parse_event::kind::option:
+		INSTRUMENT(stats_.estimate_allocation(options);)
+		options_.emplace_back(std::string_view {argv[event.index]});
+		break;
+
+	    case parse_event::kind::argument:
+		if (event.value.data() == argv[event.index])
+		{
+		    INSTRUMENT(stats_.estimate_allocation(options);)
+		    options_.emplace_back(event.value);
+		}
+		break;
+
+	    case parse_event::kind::positional:
+		INSTRUMENT(stats_.estimate_allocation(positional_options_);)
+		positional_options_.emplace_back(event.value);
+		break;
+
+	    case parse_event::kind::pass_through:
+		if (pass_through_.empty() ||
+		    pass_through_.back().data() + pass_through_.back().size() !=
+		    argv + event.index)
+		{
+		    INSTRUMENT(stats_.estimate_allocation(pass_through_);)
+		    pass_through_.emplace_back(argv + event.index, 1);
+		}
+
+		else
+		{
+		    auto first = pass_through_.back().data();
+
+		    pass_through_.back() = {first, argv + event.index + 1};
+		}
+		break;
+	    }
+	});
+    }
+
+    template<
+	typename LookupPolicy,
+	typename StoragePolicy,
+	typename ErrorPolicy,
+	typename Allocator
+    >
+    void
+    basic_parser<LookupPolicy, StoragePolicy, ErrorPolicy, Allocator>::
+    check_required_options()
+    {
+	INSTRUMENT(auto start = std::chrono::steady_clock::now();)
+
+	auto id = compiled->find_missing_required(presence);
+
+	INSTRUMENT(
+	    stats_.required_check += std::chrono::steady_clock::now() - start;
+	)
+
+	while (id != grammar::npos)
+	{
+	    auto& option = (*compiled)[id];
+
+	    raise_error(
+		{
+		    diagnostic::kind::option_is_required_but_not_added,
+		    diagnostic::no_index,
+		    id
+		},
+		[&]
+		{
+		    return error::option_is_required_but_not_added {
+			option.short_name().empty() ?
+			    option.long_name() :
+			    option.short_name(),
+			EXCEPTION_SOURCE_INFORMATION
+		    };
+		});
+
+	    if (errors_.stopped())
+	    {
+		return;
+	    }
+
+	    grammar::set(presence, id);
+
+	    id = compiled->find_missing_required(presence);
+	}
+    }
+
+    template<
+	typename LookupPolicy,
+	typename StoragePolicy,
+	typename ErrorPolicy,
+	typename Allocator
+    >
+    bool
+    basic_parser<LookupPolicy, StoragePolicy, ErrorPolicy, Allocator>::
+    next_event(parse_state& state, parse_event& event)
+    {
+	if (state.has_pending_argument)
 	{
-	    return find_option_in_dictionary(option_name)
-		->operator[](option_name);
+	    event = state.pending_argument;
+
+	    state.has_pending_argument = false;
+
+	    return true;
 	}
 
-	std::vector<dictionary> dictionaries;
+	// Loops only past options the error policy let through unresolved.
+	for (;;)
+	{
+	    if (state.index >= state.argc || state.argv[state.index] == nullptr)
+	    {
+		return false;
+	    }
 
-	parsed_command_line           options_;
-	std::vector<std::string_view> positional_options_;
-    };
+	    int index = state.index++;
+
+	    INSTRUMENT(++stats_.tokens;)
+
+	    std::string_view token = state.argv[index];
+
+	    if (not is_option_name(token))
+	    {
+		event = {
+		    state.passing_through ?
+			parse_event::kind::pass_through :
+			parse_event::kind::positional,
+		    index,
+		    nullptr,
+		    token
+		};
+
+		return true;
+	    }
+
+	    auto option_name = token.substr(0, token.find('='));
+
+	    auto id = resolve_option(state, option_name);
+
+	    if (id == unrecognized)
+	    {
+		state.passing_through = true;
+
+		event = {parse_event::kind::pass_through, index, nullptr, token};
+
+		return true;
+	    }
+
+	    if (id == grammar::npos)
+	    {
+		if (errors_.stopped())
+		{
+		    return false;
+		}
+
+		continue;
+	    }
+
+	    state.passing_through = false;
+
+	    auto& option = (*compiled)[id];
+
+	    event = {parse_event::kind::option, index, &option, option_name};
+
+	    if (is_long_option_name_with_argument(token))
+	    {
+		auto argument = token.substr(option_name.size() + 1);
+
+		if (argument.empty())
+		{
+		    raise_error(
+			{diagnostic::kind::option_expects_argument, index, id},
+			[&]
+			{
+			    return error::option_expects_argument {
+				token,
+				EXCEPTION_SOURCE_INFORMATION
+			    };
+			});
+
+		    return not errors_.stopped();
+		}
+
+		state.pending_argument = {
+		    parse_event::kind::argument, index, &option, argument
+		};
+
+		state.has_pending_argument = true;
+	    }
+
+	    else if (compiled->has_arguments(id))
+	    {
+		if (state.index < state.argc &&
+		    state.argv[state.index]  &&
+		    not is_option_name(std::string_view {state.argv[state.index]}))
+		{
+		    state.pending_argument = {
+			parse_event::kind::argument,
+			state.index,
+			&option,
+			state.argv[state.index]
+		    };
+
+		    state.has_pending_argument = true;
+
+		    ++state.index;
+
+		    INSTRUMENT(++stats_.tokens;)
+		}
+
+		else
+		{
+		    raise_error(
+			{diagnostic::kind::option_expects_argument, index, id},
+			[&]
+			{
+			    return error::option_expects_argument {
+				token,
+				EXCEPTION_SOURCE_INFORMATION
+			    };
+			});
+
+		    return not errors_.stopped();
+		}
+	    }
+
+	    return true;
+	}
+    }
+
+    // Returns npos for every error the policy raised without throwing.
+    template<
+	typename LookupPolicy,
+	typename StoragePolicy,
+	typename ErrorPolicy,
+	typename Allocator
+    >
+    grammar::size_type
+    basic_parser<LookupPolicy, StoragePolicy, ErrorPolicy, Allocator>::
+    resolve_option(const parse_state& state, std::string_view option_name)
+    {
+	INSTRUMENT(
+	    ++stats_.lookups;
+
+	    auto start = std::chrono::steady_clock::now();
+	)
+
+	auto id = find_option(option_name INSTRUMENT(, &stats_));
+
+	int index = state.index - 1;
+
+	if (id == grammar::npos && passes_through_)
+	{
+	    return unrecognized;
+	}
+
+	if (id == grammar::npos)
+	{
+	    raise_error(
+		{diagnostic::kind::unrecognized_option, index, grammar::npos},
+		[&]
+		{
+		    return error::unrecognized_option {
+			option_name,
+			EXCEPTION_SOURCE_INFORMATION
+		    };
+		});
+
+	    return grammar::npos;
+	}
+
+	if (id == grammar::ambiguous)
+	{
+	    raise_error(
+		{diagnostic::kind::ambiguous_option, index, grammar::npos},
+		[&]
+		{
+		    return error::ambiguous_option {
+			option_name,
+			EXCEPTION_SOURCE_INFORMATION
+		    };
+		});
+
+	    return grammar::npos;
+	}
+
+	if (grammar::test(presence, id) && not compiled->has_arguments(id))
+	{
+	    for (int i = 1; i < index; ++i)
+	    {
+		std::string_view token = state.argv[i];
+
+		if (is_option_name(token))
+		{
+		    auto added_as = token.substr(0, token.find('='));
+
+		    if (find_option(added_as) == id)
+		    {
+			raise_error(
+			    {diagnostic::kind::option_already_added_as, index, id},
+			    [&]
+			    {
+				return error::option_already_added_as {
+				    option_name,
+				    token,
+				    EXCEPTION_SOURCE_INFORMATION
+				};
+			    });
+
+			return grammar::npos;
+		    }
+		}
+	    }
+	}
+
+	grammar::set(presence, id);
+
+	TRACEPOINT(option__resolve, index, id);
+
+	INSTRUMENT(stats_.resolve += std::chrono::steady_clock::now() - start;)
+
+	return id;
+    }
+
+    // Larger grammars take one pass over argv per window of ids. Every
+    // pass stops at the earliest error found so far, so later passes only
+    // look for repeated options before it; missing required options are
+    // only reported once no pass found an error in argv.
+    template<
+	typename LookupPolicy,
+	typename StoragePolicy,
+	typename ErrorPolicy,
+	typename Allocator
+    >
+    std::optional<diagnostic>
+    basic_parser<LookupPolicy, StoragePolicy, ErrorPolicy, Allocator>::
+    validate(int argc, const char** argv) const noexcept
+    {
+	std::array<std::uint64_t, validate_window / 64> presence;
+
+	std::optional<diagnostic> found;
+
+	auto missing = grammar::npos;
+
+	int limit = argc;
+
+	grammar::size_type first_id = 0;
+
+	do
+	{
+	    presence.fill(0);
+
+	    for (int index = 1; index < limit && argv[index]; ++index)
+	    {
+		std::string_view token = argv[index];
+
+		if (not is_option_name(token))
+		{
+		    continue;
+		}
+
+		auto option_name = token.substr(0, token.find('='));
+
+		auto id = find_option(option_name);
+
+		if (id == grammar::npos && passes_through_)
+		{
+		    continue;
+		}
+
+		if (id == grammar::npos || id == grammar::ambiguous)
+		{
+		    found = diagnostic {
+			id == grammar::npos ?
+			    diagnostic::kind::unrecognized_option :
+			    diagnostic::kind::ambiguous_option,
+			index,
+			grammar::npos
+		    };
+
+		    limit = index;
+
+		    break;
+		}
+
+		bool has_arguments = compiled->has_arguments(id);
+
+		if (id >= first_id && id - first_id < validate_window)
+		{
+		    if (grammar::test(presence, id - first_id) &&
+			not has_arguments)
+		    {
+			found = diagnostic {
+			    diagnostic::kind::option_already_added_as,
+			    index,
+			    id
+			};
+
+			limit = index;
+
+			break;
+		    }
+
+		    grammar::set(presence, id - first_id);
+		}
+
+		bool expects_argument = false;
+
+		if (is_long_option_name_with_argument(token))
+		{
+		    expects_argument = token.size() == option_name.size() + 1;
+		}
+
+		else if (has_arguments)
+		{
+		    if (index + 1 < argc &&
+			argv[index + 1]  &&
+			not is_option_name(std::string_view {argv[index + 1]}))
+		    {
+			++index;
+		    }
+
+		    else
+		    {
+			expects_argument = true;
+		    }
+		}
+
+		if (expects_argument)
+		{
+		    found = diagnostic {
+			diagnostic::kind::option_expects_argument,
+			index,
+			id
+		    };
+
+		    limit = index;
+
+		    break;
+		}
+	    }
+
+	    if (not found && missing == grammar::npos)
+	    {
+		missing = compiled->find_missing_required(presence,
+							  first_id / 64);
+	    }
+
+	    first_id += validate_window;
+	}
+	while (first_id < compiled->size());
+
+	if (found)
+	{
+	    return found;
+	}
+
+	if (missing != grammar::npos)
+	{
+	    return diagnostic {
+		diagnostic::kind::option_is_required_but_not_added,
+		diagnostic::no_index,
+		missing
+	    };
+	}
+
+	return {};
+    }
+
+    // Whatever the parse spent outside name resolution and the required
+    // check is attributed to tokenizing.
+    template<
+	typename LookupPolicy,
+	typename StoragePolicy,
+	typename ErrorPolicy,
+	typename Allocator
+    >
+    void
+    basic_parser<LookupPolicy, StoragePolicy, ErrorPolicy, Allocator>::
+    publish_stats([[maybe_unused]] parse_stats::duration elapsed)
+    {
+	INSTRUMENT(
+	    stats_.tokenize = elapsed - stats_.resolve - stats_.required_check;
+
+	    if (stats_hook_)
+	    {
+		stats_hook_(stats_);
+	    }
+	)
+    }
+
+    template<
+	typename LookupPolicy,
+	typename StoragePolicy,
+	typename ErrorPolicy,
+	typename Allocator
+    >
+    auto
+    basic_parser<LookupPolicy, StoragePolicy, ErrorPolicy, Allocator>::
+    find_option_with_validation(std::string_view option_name) const noexcept
+	-> typename parsed_command_line::const_iterator
+    {
+	if (auto id = compiled->find(option_name); id != grammar::npos)
+	{
+	    auto& option = (*compiled)[id];
+
+	    return std::find_if(options_.cbegin(),
+				options_.cend(),
+				[&](auto&& op)
+				{
+				    if (option == op)
+				    {
+					return true;
+				    }
+
+				    return abbreviations_        &&
+					   is_option_name(op)    &&
+					   find_option(op) == id;
+				});
+	}
+
+	return options_.cend();
+    }
+
+    using parser = basic_parser<
+	automatic_lookup,
+	vector_storage,
+	throw_errors,
+	std::pmr::polymorphic_allocator<>
+    >;
+
+    extern template class basic_parser<
+	automatic_lookup,
+	vector_storage,
+	throw_errors,
+	std::pmr::polymorphic_allocator<>
+    >;
 }
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <type_traits>
+#include <cstddef>
+#include <utility>
+#include <memory>
+#include <vector>
+#include <array>
+#include <span>
+
+#include "core/inline_vector.hpp"
+#include "core/diagnostic.hpp"
+#include "core/grammar.hpp"
+
+#include "generic/error_handler.hpp"
+#include "generic/exception.hpp"
+
+namespace cli::core
+{
+    // Lookup policies fix the strategy the parser compiles its grammar
+    // with, and its lookups call that strategy directly rather than
+    // dispatching on the grammar at run time. parser::lookup_strategy can
+    // still override it, at the cost of the run time dispatch.
+    template<grammar::lookup_strategy Strategy>
+    struct lookup_policy final
+    {
+	static constexpr grammar::lookup_strategy strategy = Strategy;
+    };
+
+    using automatic_lookup =
+	lookup_policy<grammar::lookup_strategy::automatic>;
+
+    using linear_lookup =
+	lookup_policy<grammar::lookup_strategy::linear>;
+
+    using binary_search_lookup =
+	lookup_policy<grammar::lookup_strategy::binary_search>;
+
+    using hash_lookup =
+	lookup_policy<grammar::lookup_strategy::hash>;
+
+    using trie_lookup =
+	lookup_policy<grammar::lookup_strategy::trie>;
+
+    // Storage policies choose the container parsed options and
+    // positional options are kept in.
+    struct vector_storage final
+    {
+	template<typename T, typename Allocator>
+	using container = std::vector<
+	    T,
+	    typename std::allocator_traits<Allocator>::template rebind_alloc<T>
+	>;
+    };
+
+    // Keeps up to N tokens inside the parser itself, so typical command
+    // lines are parsed without touching the allocator at all.
+    template<std::size_t N>
+    struct flat_storage final
+    {
+	template<typename T, typename Allocator>
+	using container = inline_vector<
+	    T,
+	    N,
+	    typename std::allocator_traits<Allocator>::template rebind_alloc<T>
+	>;
+    };
+
+    // Error policies decide what a parse error does. Each error arrives as
+    // a compact diagnostic together with a function building the full
+    // error object, so policies that only keep diagnostics never build it.
+    //
+    // throw_errors raises the error through generic::raise, which throws
+    // or, built without exceptions, calls the error handler and aborts.
+    struct throw_errors final
+    {
+	using result_type = void;
+
+	template<typename MakeError>
+	[[noreturn]] void raise(const diagnostic&, MakeError&& make_error)
+	{
+	    generic::raise(make_error());
+	}
+
+	static constexpr bool stopped() noexcept
+	{
+	    return false;
+	}
+
+	void reset() noexcept
+	{}
+
+	result_type result() const noexcept
+	{}
+    };
+
+    // Keeps the first error, stops the parse and makes parse_command_line
+    // return whether it succeeded. The error keeps its own type, so it can
+    // be told apart with dynamic_cast or error_as.
+    class expect_errors final
+    {
+    public:
+
+	using result_type = bool;
+
+	template<typename MakeError>
+	void raise(const core::diagnostic& diagnostic, MakeError&& make_error)
+	{
+	    using error_type = std::decay_t<decltype(make_error())>;
+
+	    if (not error_)
+	    {
+		error_ = std::make_shared<const error_type>(make_error());
+
+		diagnostic_ = diagnostic;
+	    }
+	}
+
+	bool stopped() const noexcept
+	{
+	    return error_ != nullptr;
+	}
+
+	void reset() noexcept
+	{
+	    error_.reset();
+	}
+
+	result_type result() const noexcept
+	{
+	    return not stopped();
+	}
+
+	const generic::exception* error() const noexcept
+	{
+	    return error_.get();
+	}
+
+	// The error if it is an Error, nullptr otherwise.
+	template<typename Error>
+	const Error* error_as() const noexcept
+	{
+	    return dynamic_cast<const Error*>(error_.get());
+	}
+
+	const core::diagnostic& diagnostic() const noexcept
+	{
+	    return diagnostic_;
+	}
+
+    private:
+
+	std::shared_ptr<const generic::exception> error_;
+
+	core::diagnostic diagnostic_;
+    };
+
+    // Parses past every error and records up to N diagnostics in place;
+    // parse_command_line returns them all at once. Unrecognized and
+    // repeated options are skipped, an option missing its argument is
+    // kept without one and every missing required option is reported.
+    template<std::size_t N>
+    class collect_errors final
+    {
+    public:
+
+	using result_type = std::span<const diagnostic>;
+
+	template<typename MakeError>
+	void raise(const diagnostic& diagnostic, MakeError&&) noexcept
+	{
+	    if (size_ < N)
+	    {
+		diagnostics[size_++] = diagnostic;
+	    }
+
+	    else
+	    {
+		++dropped_;
+	    }
+	}
+
+	static constexpr bool stopped() noexcept
+	{
+	    return false;
+	}
+
+	void reset() noexcept
+	{
+	    size_    = 0;
+	    dropped_ = 0;
+	}
+
+	result_type result() const noexcept
+	{
+	    return {diagnostics.data(), size_};
+	}
+
+	// Diagnostics that did not fit into the buffer.
+	std::size_t dropped() const noexcept
+	{
+	    return dropped_;
+	}
+
+    private:
+
+	std::array<diagnostic, N> diagnostics {};
+
+	std::size_t size_    = 0;
+	std::size_t dropped_ = 0;
+    };
+}
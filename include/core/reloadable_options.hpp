@@ -0,0 +1,146 @@
+#pragma once
+
+#include <initializer_list>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <array>
+#include <mutex>
+#include <span>
+
+#include "core/owned_command_line.hpp"
+#include "core/option_map.hpp"
+#include "core/dictionary.hpp"
+#include "core/grammar.hpp"
+#include "core/option.hpp"
+#include "core/parser.hpp"
+
+namespace cli::core
+{
+    // Options that can be reloaded while other threads read them.
+    //
+    // reload parses the new command line off to the side, into a snapshot
+    // owning its tokens, and publishes it with one atomic store. Readers
+    // never lock: read() registers with the current epoch, and a reload
+    // sleeps until the last reader of the previous epoch leaves before
+    // freeing the snapshot they may hold. Reloads are serialized.
+    class reloadable_options final
+    {
+	struct snapshot final
+	{
+	    snapshot(const parser& parsed, const option_map& prototype) :
+		command_line {parsed},
+		map          {prototype}
+	    {
+		map.add_command_line_options(command_line.options());
+	    }
+
+	    owned_command_line command_line;
+	    option_map         map;
+	};
+
+    public:
+
+	// Keeps a snapshot alive for as long as it exists; meant to be
+	// short lived, since a reload waits for it.
+	class reader final
+	{
+	public:
+
+	    reader(const reader&) = delete;
+
+	    reader& operator=(const reader&) = delete;
+
+	    // The last reader of an epoch wakes a reload waiting for it.
+	    ~reader()
+	    {
+		if (readers->fetch_sub(1) == 1)
+		{
+		    readers->notify_all();
+		}
+	    }
+
+	    const option_map& operator*() const noexcept
+	    {
+		return current->map;
+	    }
+
+	    const option_map* operator->() const noexcept
+	    {
+		return &current->map;
+	    }
+
+	    std::span<const std::string_view>
+	    positional_options() const noexcept
+	    {
+		return current->command_line.positional_options();
+	    }
+
+	private:
+
+	    friend reloadable_options;
+
+	    reader(const snapshot*            current,
+		   std::atomic<std::size_t>* readers) noexcept :
+		current {current},
+		readers {readers}
+	    {}
+
+	    const snapshot*            current;
+	    std::atomic<std::size_t>* readers;
+	};
+
+	explicit reloadable_options(std::initializer_list<dictionary>);
+
+	reloadable_options(const reloadable_options&) = delete;
+
+	reloadable_options& operator=(const reloadable_options&) = delete;
+
+	~reloadable_options()
+	{
+	    delete current.load();
+	}
+
+	reader read() const noexcept;
+
+	// Parses and publishes a new command line and returns the ids of
+	// the options that were added, removed or given other arguments,
+	// in ascending order. Parse errors are raised before anything is
+	// published.
+	std::vector<grammar::size_type> reload(int, const char**);
+
+	std::vector<grammar::size_type> reload(int argc, char** argv)
+	{
+	    return reload(argc, const_cast<const char**>(argv));
+	}
+
+	const core::option& option_of(grammar::size_type id) const noexcept
+	{
+	    return (*compiled)[id];
+	}
+
+	// The number of reloads published so far.
+	std::uint64_t generation() const noexcept
+	{
+	    return epoch.load();
+	}
+
+    private:
+
+	const parser     parser_prototype;
+	const option_map map_prototype;
+
+	std::shared_ptr<const grammar> compiled;
+
+	std::atomic<const snapshot*> current;
+
+	std::atomic<std::uint64_t> epoch {0};
+
+	mutable std::array<std::atomic<std::size_t>, 2> readers {};
+
+	std::mutex writer;
+    };
+}
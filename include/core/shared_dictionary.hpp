@@ -0,0 +1,152 @@
+#pragma once
+
+#include <string_view>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "dictionary.hpp"
+#include "option.hpp"
+
+namespace cli::core
+{
+    class shared_dictionary final
+    {
+    public:
+
+	using value_type      = dictionary::value_type;
+	using const_reference = dictionary::const_reference;
+	using const_iterator  = dictionary::const_iterator;
+	using size_type       = dictionary::size_type;
+
+	shared_dictionary() :
+	    shared_dictionary {dictionary {}}
+	{}
+
+	shared_dictionary(const dictionary&);
+
+	shared_dictionary(dictionary&&);
+
+	shared_dictionary(const shared_dictionary&) = default;
+
+	shared_dictionary(shared_dictionary&&) noexcept = default;
+
+	shared_dictionary& operator=(const shared_dictionary&) = default;
+
+	shared_dictionary& operator=(shared_dictionary&&) noexcept = default;
+
+	const dictionary& operator*() const noexcept
+	{
+	    return entry->dictionary;
+	}
+
+	const dictionary* operator->() const noexcept
+	{
+	    return &entry->dictionary;
+	}
+
+	const_iterator cbegin() const noexcept
+	{
+	    return entry->dictionary.cbegin();
+	}
+
+	const_iterator begin() const noexcept
+	{
+	    return entry->dictionary.begin();
+	}
+
+	bool contains(const_reference option) const noexcept
+	{
+	    return entry->dictionary.contains(option);
+	}
+
+	bool contains(std::string_view option_name) const noexcept
+	{
+	    return entry->dictionary.contains(option_name);
+	}
+
+	bool empty() const noexcept
+	{
+	    return entry->dictionary.empty();
+	}
+
+	const_iterator cend() const noexcept
+	{
+	    return entry->dictionary.cend();
+	}
+
+	const_iterator end() const noexcept
+	{
+	    return entry->dictionary.end();
+	}
+
+	std::uint64_t fingerprint() const noexcept
+	{
+	    return entry->fingerprint;
+	}
+
+	bool shares(const shared_dictionary& other) const noexcept
+	{
+	    return entry == other.entry;
+	}
+
+	size_type size() const noexcept
+	{
+	    return entry->dictionary.size();
+	}
+
+	const_reference operator[](const_reference option) const
+	{
+	    return entry->dictionary[option];
+	}
+
+	const_reference operator[](std::string_view option_name) const
+	{
+	    return entry->dictionary[option_name];
+	}
+
+	static std::uint64_t fingerprint(const dictionary&) noexcept;
+
+    private:
+
+	// The entry owns the bytes of every name, representation and
+	// description: merged dictionaries come from different owners, so
+	// the views of whoever registered first cannot be kept.
+	struct shared_entry final
+	{
+	    core::dictionary        dictionary;
+	    std::unique_ptr<char[]> text;
+	    std::uint64_t           fingerprint;
+	};
+
+	// Copies or moves the dictionary only when no identical entry
+	// exists yet.
+	template<typename Dictionary>
+	static std::shared_ptr<const shared_entry> intern(Dictionary&&);
+
+	std::shared_ptr<const shared_entry> entry;
+    };
+
+    inline bool operator==(
+	const shared_dictionary& lhs, const shared_dictionary& rhs) noexcept
+    {
+	if (lhs.shares(rhs))
+	{
+	    return true;
+	}
+
+	return lhs.fingerprint() == rhs.fingerprint() && *lhs == *rhs;
+    }
+
+    inline bool operator==(
+	const shared_dictionary& lhs, const dictionary& rhs) noexcept
+    {
+	return *lhs == rhs;
+    }
+
+    inline bool operator==(
+	const dictionary& lhs, const shared_dictionary& rhs) noexcept
+    {
+	return lhs == *rhs;
+    }
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <string_view>
+#include <string>
+
+#include "generic/exception.hpp"
+
+namespace cli::error
+{
+    class ambiguous_option final : public generic::exception
+    {
+    public:
+
+	ambiguous_option(
+	    std::string_view option,
+	    std::string_view where = {})
+	    :
+	    generic::exception {
+		std::string("ambiguous option").append(" ").append(option),
+		where
+	    }
+	{}
+    };
+}
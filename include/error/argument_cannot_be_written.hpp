@@ -0,0 +1,24 @@
+#pragma once
+
+#include <string_view>
+#include <string>
+
+#include "generic/exception.hpp"
+
+namespace cli::error
+{
+    class argument_cannot_be_written final : public generic::exception
+    {
+    public:
+
+	argument_cannot_be_written(
+	    std::string_view argument,
+	    std::string_view where = {})
+	    :
+	    generic::exception {
+		std::string("cannot write argument ").append(argument),
+		where
+	    }
+	{}
+    };
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <string_view>
+#include <string>
+
+#include "generic/exception.hpp"
+
+namespace cli::error
+{
+    class argument_without_option final : public generic::exception
+    {
+    public:
+
+	argument_without_option(
+            std::string_view argument, std::string_view where = {})
+	    :
+	    generic::exception {
+		std::string("argument ").append(argument).append(
+		    " without option"),
+		where
+	    }
+	{}
+    };
+}
@@ -4,6 +4,11 @@
 #include "accessing_option_without_arguments.hpp"
 #include "option_is_required_but_not_added.hpp"
 #include "accessing_option_not_yet_added.hpp"
+#include "argument_cannot_be_written.hpp"
+#include "argument_without_option.hpp"
 #include "option_expects_argument.hpp"
 #include "option_already_added_as.hpp"
+#include "unrecognized_subcommand.hpp"
+#include "invalid_snapshot.hpp"
 #include "unrecognized_option.hpp"
+#include "ambiguous_option.hpp"
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string_view>
+#include <string>
+
+#include "generic/exception.hpp"
+
+namespace cli::error
+{
+    class invalid_snapshot final : public generic::exception
+    {
+    public:
+
+	invalid_snapshot(
+	    std::string_view reason,
+	    std::string_view where = {})
+	    :
+	    generic::exception {
+		std::string("invalid snapshot:")
+		    .append(" ")
+		    .append(reason),
+		where
+	    }
+	{}
+    };
+}
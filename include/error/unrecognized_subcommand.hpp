@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string_view>
+#include <string>
+
+#include "generic/exception.hpp"
+
+namespace cli::error
+{
+    class unrecognized_subcommand final : public generic::exception
+    {
+    public:
+
+	unrecognized_subcommand(
+	    std::string_view subcommand,
+	    std::string_view where = {})
+	    :
+	    generic::exception {
+		std::string("unrecognized subcommand")
+		    .append(" ")
+		    .append(subcommand),
+		where
+	    }
+	{}
+    };
+}
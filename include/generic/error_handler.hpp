@@ -0,0 +1,45 @@
+#pragma once
+
+#include <exception>
+#include <cstdlib>
+#include <utility>
+#include <atomic>
+
+#include "configuration/exceptions.hpp"
+
+namespace cli::generic
+{
+    // Called with every error the library raises, before it is thrown or,
+    // when exceptions are disabled, before the process aborts. A handler
+    // that does not return (exit, longjmp, a fatal log) replaces the abort.
+    using error_handler_type = void (*)(const std::exception&);
+
+    inline std::atomic<error_handler_type> installed_error_handler {nullptr};
+
+    inline error_handler_type error_handler() noexcept
+    {
+	return installed_error_handler.load(std::memory_order_acquire);
+    }
+
+    // Installs handler and returns the previous one; nullptr uninstalls.
+    inline error_handler_type error_handler(error_handler_type handler) noexcept
+    {
+	return installed_error_handler.exchange(handler,
+						std::memory_order_acq_rel);
+    }
+
+    template<typename Error>
+    [[noreturn]] void raise(Error&& error)
+    {
+	if (auto handler = error_handler())
+	{
+	    handler(error);
+	}
+
+#if EXCEPTIONS_ENABLED
+	throw std::forward<Error>(error);
+#else
+	std::abort();
+#endif
+    }
+}
@@ -4,6 +4,8 @@
 #include <exception>
 #include <string>
 
+#include "configuration/tracing.hpp"
+
 namespace cli::generic
 {
     class exception : public std::exception
@@ -16,7 +18,9 @@ namespace cli::generic
 		what :
 		std::string(where).append(": ").append(what)
 	    }
-	{}
+	{
+	    TRACEPOINT(error, what_.c_str());
+	}
 
 	virtual ~exception() = default;
 
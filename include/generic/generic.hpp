@@ -1 +1,3 @@
+#include "error_handler.hpp"
 #include "exception.hpp"
+#include "hash.hpp"
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <string_view>
+#include <cstdint>
+#include <cstring>
+
+namespace cli::generic
+{
+    inline constexpr std::uint64_t fnv1a_offset_basis = 0xcbf29ce484222325;
+
+    inline constexpr std::uint64_t
+    fnv1a(std::uint64_t seed, std::string_view bytes) noexcept
+    {
+	for (unsigned char byte : bytes)
+	{
+	    seed = (seed ^ byte) * 0x100000001b3;
+	}
+
+	return (seed ^ bytes.size()) * 0x100000001b3;
+    }
+
+    inline constexpr std::uint64_t fnv1a(std::string_view bytes) noexcept
+    {
+	return fnv1a(fnv1a_offset_basis, bytes);
+    }
+
+    // The high and low halves of the 128 bit product folded together, the
+    // mixing step of wyhash.
+    inline std::uint64_t multiply_mix(std::uint64_t a, std::uint64_t b) noexcept
+    {
+#ifdef __SIZEOF_INT128__
+	__extension__ using uint128 = unsigned __int128;
+
+	uint128 product = static_cast<uint128>(a) * b;
+
+	return static_cast<std::uint64_t>(product) ^
+	    static_cast<std::uint64_t>(product >> 64);
+#else
+	std::uint64_t a_low = a & 0xffffffff, a_high = a >> 32;
+	std::uint64_t b_low = b & 0xffffffff, b_high = b >> 32;
+
+	std::uint64_t low_low   = a_low  * b_low;
+	std::uint64_t high_low  = a_high * b_low;
+	std::uint64_t low_high  = a_low  * b_high;
+	std::uint64_t high_high = a_high * b_high;
+
+	std::uint64_t middle =
+	    (low_low >> 32) + (high_low & 0xffffffff) + low_high;
+
+	std::uint64_t low  = (middle << 32) | (low_low & 0xffffffff);
+	std::uint64_t high = high_high + (high_low >> 32) + (middle >> 32);
+
+	return low ^ high;
+#endif
+    }
+
+    // A wyhash-style hash: 16 bytes per multiply, for keys long enough
+    // that fnv1a's byte at a time shows. Not stable across platforms of
+    // different endianness.
+    inline std::uint64_t
+    fast_hash(std::uint64_t seed, std::string_view bytes) noexcept
+    {
+	constexpr std::uint64_t p0 = 0xa0761d6478bd642f;
+	constexpr std::uint64_t p1 = 0xe7037ed1a0b428db;
+	constexpr std::uint64_t p2 = 0x8ebc6af09c88c6e3;
+
+	auto read_64 = [](const char* bytes) noexcept
+	{
+	    std::uint64_t value;
+
+	    std::memcpy(&value, bytes, sizeof(value));
+
+	    return value;
+	};
+
+	auto read_32 = [](const char* bytes) noexcept
+	{
+	    std::uint32_t value;
+
+	    std::memcpy(&value, bytes, sizeof(value));
+
+	    return std::uint64_t {value};
+	};
+
+	const char*   data = bytes.data();
+	std::size_t   size = bytes.size();
+	std::uint64_t a    = 0;
+	std::uint64_t b    = 0;
+
+	seed ^= multiply_mix(seed ^ p0, p1);
+
+	for (; size > 16; data += 16, size -= 16)
+	{
+	    seed = multiply_mix(read_64(data) ^ p1, read_64(data + 8) ^ seed);
+	}
+
+	if (size >= 8)
+	{
+	    a = read_64(data);
+	    b = read_64(data + size - 8);
+	}
+
+	else if (size >= 4)
+	{
+	    a = read_32(data);
+	    b = read_32(data + size - 4);
+	}
+
+	else if (size > 0)
+	{
+	    a = (std::uint64_t {static_cast<unsigned char>(data[0])} << 16) |
+		(std::uint64_t {static_cast<unsigned char>(data[size / 2])} << 8) |
+		static_cast<unsigned char>(data[size - 1]);
+	}
+
+	return multiply_mix(p2 ^ bytes.size(),
+			    multiply_mix(a ^ p1, b ^ seed));
+    }
+
+    inline std::uint64_t fast_hash(std::string_view bytes) noexcept
+    {
+	return fast_hash(0, bytes);
+    }
+}
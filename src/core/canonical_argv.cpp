@@ -0,0 +1,319 @@
+#include <string_view>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+#include <vector>
+#include <span>
+
+#include "configuration/exception_source_information.hpp"
+
+#include "core/canonical_argv.hpp"
+#include "core/option_map.hpp"
+#include "core/grammar.hpp"
+#include "core/option.hpp"
+
+#include "error/argument_cannot_be_written.hpp"
+#include "error/option_expects_argument.hpp"
+#include "error/unrecognized_option.hpp"
+
+#include "generic/error_handler.hpp"
+
+using namespace cli::core;
+
+namespace
+{
+    struct option_entry final
+    {
+	grammar::size_type                id;
+	std::span<const std::string_view> arguments;
+    };
+
+    // Sizes the arena in a first pass over the tokens.
+    struct token_counter final
+    {
+	void append(std::string_view piece) noexcept
+	{
+	    bytes += piece.size();
+	}
+
+	void end() noexcept
+	{
+	    ++tokens;
+	    ++bytes;
+	}
+
+	std::size_t tokens = 0;
+	std::size_t bytes  = 0;
+    };
+
+    // Fills the arena in the second.
+    struct token_writer final
+    {
+	void append(std::string_view piece) noexcept
+	{
+	    std::memcpy(text, piece.data(), piece.size());
+
+	    text += piece.size();
+	}
+
+	void end() noexcept
+	{
+	    *text++ = '\0';
+
+	    *pointer++ = std::exchange(first, text);
+	}
+
+	char** pointer;
+	char*  text;
+	char*  first = text;
+    };
+
+    [[noreturn]] void cannot_write(std::string_view argument)
+    {
+	cli::generic::raise(cli::error::argument_cannot_be_written {
+	    argument,
+	    EXCEPTION_SOURCE_INFORMATION
+	});
+    }
+
+    bool is_joinable(std::string_view argument) noexcept
+    {
+	return not argument.empty() &&
+	    argument.find(',') == std::string_view::npos;
+    }
+
+    template<typename Sink>
+    void write_option(Sink&                          sink,
+		      const grammar&                 compiled,
+		      const option_entry&            entry,
+		      canonical_argv::argument_style style)
+    {
+	auto& option = compiled[entry.id];
+
+	bool has_long = not option.long_name().empty();
+
+	auto name = has_long ? option.long_name() : option.short_name();
+
+	if (not compiled.has_arguments(entry.id))
+	{
+	    sink.append(name);
+
+	    // A repeated flag is an error, so arguments given to a flag as
+	    // in --verbose=x all go into its one token.
+	    for (std::size_t i = 0; i < entry.arguments.size(); ++i)
+	    {
+		auto argument = entry.arguments[i];
+
+		if (not (has_long && is_joinable(argument)))
+		{
+		    cannot_write(argument);
+		}
+
+		sink.append(i == 0 ? "=" : ",");
+		sink.append(argument);
+	    }
+
+	    sink.end();
+
+	    return;
+	}
+
+	if (entry.arguments.empty())
+	{
+	    cli::generic::raise(cli::error::option_expects_argument {
+		name,
+		EXCEPTION_SOURCE_INFORMATION
+	    });
+	}
+
+	for (auto argument : entry.arguments)
+	{
+	    bool joinable  = has_long && is_joinable(argument);
+	    bool separable = not is_option_name(argument);
+
+	    if (joinable &&
+		(style == canonical_argv::argument_style::joined ||
+		 not separable))
+	    {
+		sink.append(name);
+		sink.append("=");
+		sink.append(argument);
+		sink.end();
+	    }
+
+	    else if (separable)
+	    {
+		sink.append(name);
+		sink.end();
+
+		sink.append(argument);
+		sink.end();
+	    }
+
+	    else
+	    {
+		cannot_write(argument);
+	    }
+	}
+    }
+
+    template<typename Sink>
+    void write_tokens(Sink&                             sink,
+		      std::string_view                  program,
+		      const grammar&                    compiled,
+		      std::span<const option_entry>     entries,
+		      std::span<const std::string_view> positional_options,
+		      canonical_argv::argument_style    style)
+    {
+	sink.append(program);
+	sink.end();
+
+	for (auto&& entry : entries)
+	{
+	    write_option(sink, compiled, entry, style);
+	}
+
+	for (auto positional : positional_options)
+	{
+	    if (is_option_name(positional))
+	    {
+		cannot_write(positional);
+	    }
+
+	    sink.append(positional);
+	    sink.end();
+	}
+    }
+}
+
+canonical_argv::canonical_argv(
+    std::string_view                  program,
+    const option_map&                 map,
+    std::span<const option_override>  overrides,
+    std::span<const std::string_view> positional_options,
+    argument_style                    style,
+    const allocator_type&             allocator)
+    :
+    storage {allocator}
+{
+    const grammar& compiled = *map.compiled;
+
+    std::vector<option_entry> entries;
+
+    for (std::size_t i = 0; i < map.ids.size(); ++i)
+    {
+	if (map.ids[i] < compiled.size())
+	{
+	    entries.emplace_back(map.ids[i], map.map[i].second);
+	}
+    }
+
+    for (auto&& change : overrides)
+    {
+	auto id = compiled.find(change.option);
+
+	if (id >= compiled.size())
+	{
+	    generic::raise(error::unrecognized_option {
+		change.option,
+		EXCEPTION_SOURCE_INFORMATION
+	    });
+	}
+
+	auto iterator = std::find_if(
+	    entries.begin(),
+	    entries.end(),
+	    [&](auto&& entry)
+	    {
+		return entry.id == id;
+	    });
+
+	if (change.remove)
+	{
+	    if (iterator != entries.end())
+	    {
+		entries.erase(iterator);
+	    }
+	}
+
+	else if (iterator != entries.end())
+	{
+	    iterator->arguments = change.arguments;
+	}
+
+	else
+	{
+	    entries.emplace_back(id, change.arguments);
+	}
+    }
+
+    std::sort(entries.begin(), entries.end(), [](auto&& lhs, auto&& rhs)
+    {
+	return lhs.id < rhs.id;
+    });
+
+    token_counter counter;
+
+    write_tokens(
+	counter, program, compiled, entries, positional_options, style);
+
+    allocate(counter.tokens, counter.bytes);
+
+    token_writer writer {argv, reinterpret_cast<char*>(argv + size_ + 1)};
+
+    write_tokens(
+	writer, program, compiled, entries, positional_options, style);
+
+    *writer.pointer = nullptr;
+}
+
+canonical_argv::canonical_argv(const canonical_argv& other,
+			       const allocator_type& allocator) :
+    storage {allocator}
+{
+    if (other.argv == nullptr)
+    {
+	return;
+    }
+
+    auto bytes = other.storage.size() - (other.size_ + 1) * sizeof(char*);
+
+    allocate(other.size_, bytes);
+
+    auto* source = reinterpret_cast<const char*>(other.argv + size_ + 1);
+    auto* target = reinterpret_cast<char*>(argv + size_ + 1);
+
+    std::memcpy(target, source, bytes);
+
+    for (size_type i = 0; i < size_; ++i)
+    {
+	argv[i] = target + (other.argv[i] - source);
+    }
+
+    argv[size_] = nullptr;
+}
+
+canonical_argv& canonical_argv::operator=(canonical_argv&& other)
+{
+    if (this != &other)
+    {
+	if (not storage.take_over(other.storage))
+	{
+	    return *this = static_cast<const canonical_argv&>(other);
+	}
+
+	argv  = std::exchange(other.argv, nullptr);
+	size_ = std::exchange(other.size_, 0);
+    }
+
+    return *this;
+}
+
+void canonical_argv::allocate(size_type tokens, std::size_t bytes)
+{
+    storage.allocate((tokens + 1) * sizeof(char*) + bytes, alignof(char*));
+
+    argv  = static_cast<char**>(storage.data());
+    size_ = tokens;
+}
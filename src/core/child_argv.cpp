@@ -0,0 +1,61 @@
+#include <cstddef>
+#include <utility>
+#include <span>
+
+#include "core/child_argv.hpp"
+
+using namespace cli::core;
+
+child_argv::child_argv(std::span<const char* const>      prefix,
+		       std::span<const pass_through_type> pass_through,
+		       const allocator_type&              allocator)
+    :
+    storage {allocator},
+    size_   {prefix.size()}
+{
+    for (auto&& run : pass_through)
+    {
+	size_ += run.size();
+    }
+
+    storage.allocate((size_ + 1) * sizeof(char*), alignof(char*));
+
+    argv = static_cast<char**>(storage.data());
+
+    char** entry = argv;
+
+    // The exec family takes char* const[] for historical reasons only and
+    // never writes through the pointers.
+    auto copy = [&](std::span<const char* const> tokens)
+    {
+	for (const char* token : tokens)
+	{
+	    *entry++ = const_cast<char*>(token);
+	}
+    };
+
+    copy(prefix);
+
+    for (auto&& run : pass_through)
+    {
+	copy(run);
+    }
+
+    *entry = nullptr;
+}
+
+child_argv& child_argv::operator=(child_argv&& other)
+{
+    if (this != &other)
+    {
+	if (not storage.take_over(other.storage))
+	{
+	    return *this = static_cast<const child_argv&>(other);
+	}
+
+	argv  = std::exchange(other.argv, nullptr);
+	size_ = std::exchange(other.size_, 0);
+    }
+
+    return *this;
+}
@@ -0,0 +1,131 @@
+#include <string_view>
+#include <cstddef>
+#include <utility>
+
+#include "configuration/exception_source_information.hpp"
+
+#include "core/command_tree.hpp"
+#include "core/parser.hpp"
+
+#include "error/unrecognized_subcommand.hpp"
+
+#include "generic/error_handler.hpp"
+
+using namespace cli::core;
+
+std::size_t command_tree::add_command(
+    std::initializer_list<std::string_view> path, registration thunk)
+{
+    std::size_t current = 0;
+
+    for (auto&& name : path)
+    {
+	auto child = find_child(current, name);
+
+	if (child == npos)
+	{
+	    auto* link = &nodes[current].first_child;
+
+	    while (*link != npos && nodes[*link].name < name)
+	    {
+		link = &nodes[*link].next_sibling;
+	    }
+
+	    child = nodes.size();
+
+	    node next;
+
+	    next.name         = name;
+	    next.next_sibling = *link;
+
+	    *link = child;
+
+	    nodes.emplace_back(std::move(next));
+	}
+
+	current = child;
+    }
+
+    if (nodes[current].id == npos)
+    {
+	nodes[current].id = commands.size();
+
+	commands.emplace_back(current);
+    }
+
+    nodes[current].thunk = thunk;
+
+    return nodes[current].id;
+}
+
+command_tree::selection
+command_tree::select(int argc, const char** argv) const noexcept
+{
+    selection selected;
+
+    if (nodes.front().thunk)
+    {
+	selected.command = nodes.front().id;
+    }
+
+    std::size_t current = 0;
+
+    for (int i = 1; i < argc && argv[i]; ++i)
+    {
+	current = find_child(current, argv[i]);
+
+	if (current == npos)
+	{
+	    break;
+	}
+
+	if (nodes[current].thunk)
+	{
+	    selected.command = nodes[current].id;
+	    selected.depth   = i;
+	}
+    }
+
+    return selected;
+}
+
+command_tree::selection
+command_tree::dispatch(int argc, const char** argv, parser& parser) const
+{
+    auto selected = select(argc, argv);
+
+    if (selected.command == npos)
+    {
+	generic::raise(error::unrecognized_subcommand {
+	    argc > 1 && argv[1] ? argv[1] : "",
+	    EXCEPTION_SOURCE_INFORMATION
+	});
+    }
+
+    parser.clear();
+
+    nodes[commands[selected.command]].thunk(parser);
+
+    parser.parse_command_line(
+	argc - selected.depth, argv + selected.depth);
+
+    return selected;
+}
+
+std::size_t command_tree::find_child(
+    std::size_t parent, std::string_view name) const noexcept
+{
+    auto child = nodes[parent].first_child;
+
+    while (child != npos && nodes[child].name < name)
+    {
+	child = nodes[child].next_sibling;
+    }
+
+    if (child != npos && nodes[child].name == name)
+    {
+	return child;
+    }
+
+    return npos;
+}
@@ -0,0 +1,1194 @@
+#include <unordered_map>
+#include <string_view>
+#include <cassert>
+#include <algorithm>
+#include <fstream>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <span>
+#include <bit>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#include "configuration/instrumentation.hpp"
+
+#include "core/shared_dictionary.hpp"
+#include "core/parse_stats.hpp"
+#include "core/grammar.hpp"
+#include "core/option.hpp"
+
+#include "generic/hash.hpp"
+
+using namespace cli::core;
+
+struct grammar::trie_entry final
+{
+    std::string_view name;
+    std::uint32_t    offset;
+    std::uint32_t    id;
+};
+
+grammar::grammar(std::span<const shared_dictionary> dictionaries,
+		 lookup_strategy                   strategy) :
+    dictionaries (dictionaries.begin(), dictionaries.end()),
+    fingerprint_ {cli::generic::fnv1a_offset_basis},
+    requested    {strategy}
+{
+    built.short_table.fill(npos_id);
+
+    size_type size = 0;
+
+    for (auto&& dictionary : dictionaries)
+    {
+	size += dictionary.size();
+    }
+
+    std::unordered_map<std::string_view, std::uint32_t> interned;
+
+    auto intern = [&](std::string_view name) -> std::uint32_t
+    {
+	auto [iterator, inserted] =
+	    interned.try_emplace(name, built.names.size());
+
+	if (inserted)
+	{
+	    built.names.append(name);
+	}
+
+	return iterator->second;
+    };
+
+    std::vector<trie_entry> entries;
+
+    built.short_names.reserve(size);
+    built.long_names.reserve(size);
+    options.reserve(size);
+
+    built.required.resize((size + 63) / 64);
+    built.arguments.resize((size + 63) / 64);
+
+    for (auto&& dictionary : dictionaries)
+    {
+	for (auto&& option : dictionary)
+	{
+	    auto id = options.size();
+
+	    options.emplace_back(&option);
+
+	    if (option.has_equality_validator())
+	    {
+		built.short_names.emplace_back(0);
+		built.long_names.emplace_back();
+
+		built.validated.emplace_back(id);
+	    }
+
+	    else
+	    {
+		auto short_name = option.short_name();
+		auto long_name  = option.long_name();
+
+		built.short_names.emplace_back(
+		    short_name.empty() ? 0 : short_name[1]);
+
+		if (auto& slot = built.short_table[built.short_names.back()];
+		    not short_name.empty() && slot == npos_id)
+		{
+		    slot = id;
+		}
+
+		built.long_names.emplace_back(
+		    name {intern(long_name),
+			  static_cast<std::uint32_t>(long_name.size())});
+
+		if (not long_name.empty())
+		{
+		    entries.emplace_back(
+			long_name,
+			built.long_names.back().offset,
+			static_cast<std::uint32_t>(id));
+		}
+	    }
+
+	    if (option.is_required())
+	    {
+		set(built.required, id);
+	    }
+
+	    if (option.has_arguments())
+	    {
+		set(built.arguments, id);
+	    }
+
+	    fingerprint_ = fingerprint(fingerprint_, option);
+	}
+    }
+
+    std::sort(entries.begin(), entries.end(), [](auto&& lhs, auto&& rhs)
+    {
+	return (lhs.name < rhs.name ||
+		(lhs.name == rhs.name && lhs.id < rhs.id));
+    });
+
+    built.sorted.reserve(entries.size());
+
+    for (auto&& entry : entries)
+    {
+	built.sorted.emplace_back(
+	    entry.offset,
+	    static_cast<std::uint32_t>(entry.name.size()),
+	    entry.id);
+    }
+
+    strategy_ = strategy == lookup_strategy::automatic ?
+	select_strategy(built.sorted) :
+	strategy;
+
+#ifdef CHECK_LOOKUP_STRATEGIES
+    build_hash();
+    build_trie(entries);
+#else
+    if (strategy_ == lookup_strategy::hash)
+    {
+	build_hash();
+    }
+
+    if (strategy_ == lookup_strategy::trie)
+    {
+	build_trie(entries);
+    }
+#endif
+
+    view_built();
+}
+
+grammar::size_type
+grammar::find(std::string_view option_name,
+	      [[maybe_unused]] parse_stats* stats) const noexcept
+{
+    auto found = npos;
+
+    if (is_short_option_name(option_name))
+    {
+	auto id = short_table[static_cast<unsigned char>(option_name[1])];
+
+	INSTRUMENT(if (stats) ++stats->comparisons;)
+
+	if (id != npos_id)
+	{
+	    found = id;
+	}
+    }
+
+    else
+    {
+	found = find_long(option_name, false, stats);
+    }
+
+    return find_validated(option_name, found, stats);
+}
+
+grammar::size_type
+grammar::find_abbreviated(std::string_view option_name,
+			  parse_stats* stats) const noexcept
+{
+    if (is_short_option_name(option_name))
+    {
+	return find(option_name, stats);
+    }
+
+    return find_validated(
+	option_name, find_long(option_name, true, stats), stats);
+}
+
+grammar::size_type grammar::find_missing_required(
+    std::span<const std::uint64_t> presence,
+    size_type                      first_word) const noexcept
+{
+    auto size = std::min(presence.size(),
+			 required.size() - std::min(first_word, required.size()));
+
+    for (size_type i = 0; i < size; ++i)
+    {
+	if (auto missing = required[first_word + i] & ~presence[i]; missing)
+	{
+	    return (first_word + i) * 64 + std::countr_zero(missing);
+	}
+    }
+
+    return npos;
+}
+
+// Up to linear_limit names a scan beats hashing the token. Beyond that
+// hashing wins, except for moderately sized grammars of long names where
+// walking the trie touches less than hashing and comparing every byte.
+// binary_search never measured fastest and is only used when requested.
+grammar::lookup_strategy
+grammar::select_strategy(std::span<const sorted_name> names) noexcept
+{
+    if (names.size() <= linear_limit)
+    {
+	return lookup_strategy::linear;
+    }
+
+    std::size_t total = 0;
+
+    for (auto&& name : names)
+    {
+	total += name.size;
+    }
+
+    if (names.size() <= trie_limit &&
+	total / names.size() >= trie_name_length)
+    {
+	return lookup_strategy::trie;
+    }
+
+    return lookup_strategy::hash;
+}
+
+// Open addressing over ids in grammar order, so the first option with a
+// given long name owns its slot.
+void grammar::build_hash()
+{
+    auto& hashed     = built.hashed;
+    auto& long_names = built.long_names;
+
+    auto capacity =
+	std::bit_ceil(std::max<std::size_t>(built.sorted.size() * 2, 8));
+
+    hashed.assign(capacity, npos_id);
+
+    for (std::uint32_t id = 0, size = long_names.size(); id < size; ++id)
+    {
+	if (long_names[id].size == 0)
+	{
+	    continue;
+	}
+
+	std::string_view name {
+	    built.names.data() + long_names[id].offset, long_names[id].size
+	};
+
+	auto slot = cli::generic::fnv1a(name) & (capacity - 1);
+
+	while (hashed[slot] != npos_id &&
+	       long_names[hashed[slot]].offset != long_names[id].offset)
+	{
+	    slot = (slot + 1) & (capacity - 1);
+	}
+
+	if (hashed[slot] == npos_id)
+	{
+	    hashed[slot] = id;
+	}
+    }
+}
+
+void grammar::build_trie(std::vector<trie_entry>& entries)
+{
+    built.trie.emplace_back();
+
+    if (not entries.empty())
+    {
+	build_trie_node(entries, 0, 0, entries.size(), 0);
+    }
+}
+
+void grammar::build_trie_node(
+    std::vector<trie_entry>& entries,
+    std::size_t              node,
+    std::size_t              first,
+    std::size_t              last,
+    std::size_t              depth)
+{
+    auto& front = entries[first];
+    auto& back  = entries[last - 1];
+
+    if (front.name == back.name)
+    {
+	built.trie[node].unique = front.id;
+    }
+
+    else
+    {
+	built.trie[node].unique = ambiguous_id;
+    }
+
+    if (front.name.size() == depth)
+    {
+	built.trie[node].terminal = front.id;
+
+	while (first < last && entries[first].name.size() == depth)
+	{
+	    ++first;
+	}
+    }
+
+    std::size_t children = 0;
+
+    for (auto i = first; i < last; ++children)
+    {
+	auto byte = entries[i].name[depth];
+
+	while (i < last && entries[i].name[depth] == byte)
+	{
+	    ++i;
+	}
+    }
+
+    built.trie[node].first_child = built.trie.size();
+    built.trie[node].children    = children;
+
+    built.trie.resize(built.trie.size() + children);
+
+    for (auto i = first, child = std::size_t {built.trie[node].first_child};
+	 i < last;
+	 ++child)
+    {
+	auto byte = entries[i].name[depth];
+	auto end  = i;
+
+	while (end < last && entries[end].name[depth] == byte)
+	{
+	    ++end;
+	}
+
+	auto& lhs = entries[i].name;
+	auto& rhs = entries[end - 1].name;
+
+	auto common = depth + 1;
+
+	while (common < lhs.size() &&
+	       common < rhs.size() &&
+	       lhs[common] == rhs[common])
+	{
+	    ++common;
+	}
+
+	built.trie[child].label_offset = entries[i].offset + depth;
+	built.trie[child].label_size   = common - depth;
+	built.trie[child].first        = byte;
+
+	build_trie_node(entries, child, i, end, common);
+
+	i = end;
+    }
+}
+
+grammar::size_type
+grammar::find_long(std::string_view option_name,
+		   bool             abbreviated,
+		   parse_stats*     stats) const noexcept
+{
+    size_type found = npos;
+
+    switch (strategy_)
+    {
+    case lookup_strategy::automatic:
+    case lookup_strategy::linear:
+	found = find_linear(option_name, abbreviated, stats);
+	break;
+
+    case lookup_strategy::binary_search:
+	found = find_sorted(option_name, abbreviated, stats);
+	break;
+
+    case lookup_strategy::hash:
+	found = find_hashed(option_name, abbreviated, stats);
+	break;
+
+    case lookup_strategy::trie:
+	found = find_trie(option_name, abbreviated, stats);
+	break;
+    }
+
+#ifdef CHECK_LOOKUP_STRATEGIES
+    auto reference = find_linear(option_name, abbreviated, nullptr);
+
+    assert(found == reference);
+
+    assert(find_sorted(option_name, abbreviated, nullptr) == reference);
+    assert(find_hashed(option_name, abbreviated, nullptr) == reference);
+    assert(find_trie(option_name, abbreviated, nullptr)   == reference);
+#endif
+
+    return found;
+}
+
+grammar::size_type
+grammar::prefix_match(std::uint32_t id, bool abbreviated) noexcept
+{
+    if (not abbreviated || id == npos_id)
+    {
+	return npos;
+    }
+
+    return id == ambiguous_id ? ambiguous : id;
+}
+
+grammar::size_type
+grammar::find_linear(std::string_view option_name,
+		     bool             abbreviated,
+		     [[maybe_unused]] parse_stats* stats) const noexcept
+{
+    std::uint32_t prefix = npos_id;
+
+    for (std::uint32_t id = 0, size = long_names.size(); id < size; ++id)
+    {
+	if (long_names[id].size == 0)
+	{
+	    continue;
+	}
+
+	auto name = long_name(id);
+
+	INSTRUMENT(if (stats) ++stats->comparisons;)
+
+	if (name == option_name)
+	{
+	    return id;
+	}
+
+	if (abbreviated && name.starts_with(option_name))
+	{
+	    if (prefix == npos_id)
+	    {
+		prefix = id;
+	    }
+
+	    else if (prefix != ambiguous_id &&
+		     long_names[prefix].offset != long_names[id].offset)
+	    {
+		prefix = ambiguous_id;
+	    }
+	}
+    }
+
+    return prefix_match(prefix, abbreviated);
+}
+
+grammar::size_type
+grammar::find_sorted(std::string_view option_name,
+		     bool             abbreviated,
+		     [[maybe_unused]] parse_stats* stats) const noexcept
+{
+    auto first = std::lower_bound(
+	sorted.begin(), sorted.end(), option_name, [&](auto&& name, auto&& key)
+	{
+	    INSTRUMENT(if (stats) ++stats->comparisons;)
+
+	    return name_at(name) < key;
+	});
+
+    if (first == sorted.end() || not name_at(*first).starts_with(option_name))
+    {
+	return npos;
+    }
+
+    if (name_at(*first) == option_name)
+    {
+	return first->id;
+    }
+
+    if (not abbreviated)
+    {
+	return npos;
+    }
+
+    auto last = std::partition_point(first, sorted.end(), [&](auto&& name)
+    {
+	return name_at(name).starts_with(option_name);
+    });
+
+    if (first->offset == (last - 1)->offset)
+    {
+	return first->id;
+    }
+
+    return ambiguous;
+}
+
+grammar::size_type
+grammar::find_hashed(std::string_view option_name,
+		     bool             abbreviated,
+		     [[maybe_unused]] parse_stats* stats) const noexcept
+{
+    if (hashed.empty())
+    {
+	return npos;
+    }
+
+    auto mask = hashed.size() - 1;
+
+    for (auto slot = cli::generic::fnv1a(option_name) & mask;
+	 hashed[slot] != npos_id;
+	 slot = (slot + 1) & mask)
+    {
+	INSTRUMENT(if (stats) ++stats->comparisons;)
+
+	if (long_name(hashed[slot]) == option_name)
+	{
+	    return hashed[slot];
+	}
+    }
+
+    return abbreviated ? find_sorted(option_name, true, stats) : npos;
+}
+
+grammar::size_type
+grammar::find_trie(std::string_view option_name,
+		   bool             abbreviated,
+		   [[maybe_unused]] parse_stats* stats) const noexcept
+{
+    if (trie.empty())
+    {
+	return npos;
+    }
+
+    std::size_t node     = 0;
+    std::size_t position = 0;
+
+    while (position < option_name.size())
+    {
+	auto first = trie.begin() + trie[node].first_child;
+	auto last  = first + trie[node].children;
+
+	auto byte = static_cast<unsigned char>(option_name[position]);
+
+	auto child = std::lower_bound(
+	    first, last, byte, [](auto&& node, unsigned char byte)
+	    {
+		return node.first < byte;
+	    });
+
+	if (child == last || child->first != byte)
+	{
+	    return npos;
+	}
+
+	auto size = std::min<std::size_t>(
+	    child->label_size, option_name.size() - position);
+
+	INSTRUMENT(if (stats) ++stats->comparisons;)
+
+	if (std::memcmp(names.data() + child->label_offset,
+			option_name.data() + position,
+			size) != 0)
+	{
+	    return npos;
+	}
+
+	node      = child - trie.begin();
+	position += size;
+
+	if (size < child->label_size)
+	{
+	    return prefix_match(child->unique, abbreviated);
+	}
+    }
+
+    if (trie[node].terminal != npos_id)
+    {
+	return trie[node].terminal;
+    }
+
+    return prefix_match(trie[node].unique, abbreviated);
+}
+
+grammar::size_type grammar::find_validated(
+    std::string_view option_name,
+    size_type        found,
+    [[maybe_unused]] parse_stats* stats) const noexcept
+{
+    for (auto id : validated)
+    {
+	if (id > found)
+	{
+	    break;
+	}
+
+	INSTRUMENT(if (stats) { ++stats->comparisons; ++stats->validator_calls; })
+
+	if (options[id]->equality_validator()(option_name))
+	{
+	    return id;
+	}
+    }
+
+    return found;
+}
+
+std::uint64_t
+grammar::fingerprint(std::uint64_t seed, const option& option) noexcept
+{
+    const char flags[] = {
+	option.is_required()   ? 'r' : '-',
+	option.has_arguments() ? 'a' : '-'
+    };
+
+    seed = cli::generic::fnv1a(seed, option.short_name());
+    seed = cli::generic::fnv1a(seed, option.long_name());
+
+    return cli::generic::fnv1a(seed, {flags, 2});
+}
+
+namespace
+{
+    struct registry final
+    {
+	std::mutex mutex;
+
+	std::unordered_multimap<
+	    std::uint64_t,
+	    std::weak_ptr<const grammar>
+	> grammars;
+    };
+
+    registry& interned()
+    {
+	static registry instance;
+
+	return instance;
+    }
+}
+
+template<typename Make>
+std::shared_ptr<const grammar>
+grammar::intern(std::span<const shared_dictionary> dictionaries,
+		lookup_strategy                   strategy,
+		Make&&                            make)
+{
+    auto& [mutex, grammars] = interned();
+
+    std::uint64_t key = cli::generic::fnv1a_offset_basis;
+
+    for (auto&& dictionary : dictionaries)
+    {
+	key = (key ^ dictionary.fingerprint()) * 0x100000001b3;
+    }
+
+    key = (key ^ static_cast<std::uint64_t>(strategy)) * 0x100000001b3;
+
+    std::scoped_lock lock {mutex};
+
+    auto [first, last] = grammars.equal_range(key);
+
+    while (first != last)
+    {
+	if (auto compiled = first->second.lock(); not compiled)
+	{
+	    first = grammars.erase(first);
+	}
+
+	else if (compiled->requested == strategy &&
+		 std::equal(compiled->dictionaries.cbegin(),
+			     compiled->dictionaries.cend(),
+			     dictionaries.begin(),
+			     dictionaries.end(),
+			     [](auto&& lhs, auto&& rhs)
+			     {
+				return lhs.shares(rhs);
+			     }))
+	{
+	    return compiled;
+	}
+
+	else
+	{
+	    ++first;
+	}
+    }
+
+    std::shared_ptr<const grammar> compiled = make();
+
+    // Grammars are built outside make_shared, so only the control blocks
+    // of expired ones wait here for the sweep.
+    std::erase_if(grammars, [](auto&& interned)
+    {
+	return interned.second.expired();
+    });
+
+    grammars.emplace(key, compiled);
+
+    return compiled;
+}
+
+std::shared_ptr<const grammar>
+grammar::compile(std::span<const shared_dictionary> dictionaries,
+		  lookup_strategy                   strategy)
+{
+    static const auto empty = std::make_shared<const grammar>();
+
+    if (dictionaries.empty())
+    {
+	return empty;
+    }
+
+    return intern(dictionaries, strategy, [&]
+    {
+	return std::shared_ptr<const grammar> {
+	    new grammar {dictionaries, strategy}
+	};
+    });
+}
+
+// A grammar file starts with this header, followed by the tables of the
+// index, each at an offset aligned for its elements. The tables are
+// stored as laid out in memory, so a file only suits builds sharing that
+// layout, which layout records.
+struct grammar::file_header final
+{
+    enum table : std::size_t
+    {
+	short_table_table = 0,
+	names_table,
+	short_names_table,
+	long_names_table,
+	sorted_table,
+	hashed_table,
+	trie_table,
+	required_table,
+	arguments_table,
+	validated_table,
+	table_count
+    };
+
+    struct section final
+    {
+	std::uint64_t offset = 0;
+	std::uint64_t size   = 0;
+    };
+
+    static constexpr std::uint32_t magic_value   = 0x4d524743;
+    static constexpr std::uint32_t version_value = 1;
+
+    static constexpr std::uint32_t layout_value =
+	sizeof(name) |
+	sizeof(sorted_name) << 8 |
+	sizeof(trie_node) << 16 |
+	sizeof(section) << 24;
+
+    std::uint32_t magic       = magic_value;
+    std::uint32_t version     = version_value;
+    std::uint32_t layout      = layout_value;
+    std::uint8_t  requested   = 0;
+    std::uint8_t  strategy    = 0;
+    std::uint8_t  padding[2]  = {};
+    std::uint64_t fingerprint = 0;
+    std::uint64_t options     = 0;
+
+    section sections[table_count];
+};
+
+namespace
+{
+    // Maps the whole file read only; mapping holds it until released.
+    std::span<const std::byte>
+    map_file(const char* path, std::shared_ptr<const void>& mapping)
+    {
+	int descriptor = ::open(path, O_RDONLY | O_CLOEXEC);
+
+	if (descriptor < 0)
+	{
+	    return {};
+	}
+
+	struct stat status;
+
+	void* data = MAP_FAILED;
+
+	if (::fstat(descriptor, &status) == 0 && status.st_size > 0)
+	{
+	    data = ::mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE,
+			  descriptor, 0);
+	}
+
+	::close(descriptor);
+
+	if (data == MAP_FAILED)
+	{
+	    return {};
+	}
+
+	std::size_t size = status.st_size;
+
+	mapping = std::shared_ptr<const void> {data, [size](void* data)
+	{
+	    ::munmap(data, size);
+	}};
+
+	return {static_cast<const std::byte*>(data), size};
+    }
+}
+
+grammar::grammar(std::span<const shared_dictionary> dictionaries,
+		 lookup_strategy                   requested,
+		 std::vector<const option*>        options,
+		 std::shared_ptr<const void>       mapping,
+		 const file_header&                header) :
+    dictionaries (dictionaries.begin(), dictionaries.end()),
+    mapping      {std::move(mapping)},
+    options      {std::move(options)},
+    fingerprint_ {header.fingerprint},
+    requested    {requested},
+    strategy_    {static_cast<lookup_strategy>(header.strategy)}
+{
+    auto* base = static_cast<const std::byte*>(this->mapping.get());
+
+    auto view = [&]<typename T>(std::span<const T>& table, std::size_t index)
+    {
+	auto& section = header.sections[index];
+
+	table = {reinterpret_cast<const T*>(base + section.offset),
+		 static_cast<std::size_t>(section.size)};
+    };
+
+    std::span<const char> characters;
+
+    view(short_table, file_header::short_table_table);
+    view(characters,  file_header::names_table);
+    view(short_names, file_header::short_names_table);
+    view(long_names,  file_header::long_names_table);
+    view(sorted,      file_header::sorted_table);
+    view(hashed,      file_header::hashed_table);
+    view(trie,        file_header::trie_table);
+    view(required,    file_header::required_table);
+    view(arguments,   file_header::arguments_table);
+    view(validated,   file_header::validated_table);
+
+    names = {characters.data(), characters.size()};
+}
+
+std::vector<std::byte> grammar::serialize() const
+{
+    file_header header;
+
+    header.requested   = static_cast<std::uint8_t>(requested);
+    header.strategy    = static_cast<std::uint8_t>(strategy_);
+    header.fingerprint = fingerprint_;
+    header.options     = options.size();
+
+    std::vector<std::byte> file (sizeof(header));
+
+    auto append = [&]<typename T>(std::span<const T> table, std::size_t index)
+    {
+	auto offset = (file.size() + alignof(T) - 1) / alignof(T) * alignof(T);
+	auto bytes  = std::as_bytes(table);
+
+	header.sections[index] = {offset, table.size()};
+
+	file.resize(offset + bytes.size());
+
+	if (not bytes.empty())
+	{
+	    std::memcpy(file.data() + offset, bytes.data(), bytes.size());
+	}
+    };
+
+    append(short_table, file_header::short_table_table);
+    append(std::span {names}, file_header::names_table);
+    append(short_names, file_header::short_names_table);
+    append(long_names,  file_header::long_names_table);
+    append(sorted,      file_header::sorted_table);
+    append(hashed,      file_header::hashed_table);
+    append(trie,        file_header::trie_table);
+    append(required,    file_header::required_table);
+    append(arguments,   file_header::arguments_table);
+    append(validated,   file_header::validated_table);
+
+    std::memcpy(file.data(), &header, sizeof(header));
+
+    return file;
+}
+
+bool grammar::valid_tables() const noexcept
+{
+    std::uint64_t size = options.size();
+
+    auto valid_id = [&](std::uint32_t id)
+    {
+	return id == npos_id || id < size;
+    };
+
+    auto in_names = [&](std::uint64_t offset, std::uint64_t length)
+    {
+	return offset + length <= names.size();
+    };
+
+    for (std::size_t byte = 0; byte < short_table.size(); ++byte)
+    {
+	if (auto id = short_table[byte];
+	    id != npos_id && (id >= size || short_names[id] != byte))
+	{
+	    return false;
+	}
+    }
+
+    std::size_t long_named = 0;
+
+    for (auto&& name : long_names)
+    {
+	if (not in_names(name.offset, name.size))
+	{
+	    return false;
+	}
+
+	long_named += name.size != 0;
+    }
+
+    if (sorted.size() != long_named)
+    {
+	return false;
+    }
+
+    for (std::size_t i = 0; i < sorted.size(); ++i)
+    {
+	auto& entry = sorted[i];
+
+	if (entry.id >= size ||
+	    long_names[entry.id].offset != entry.offset ||
+	    long_names[entry.id].size   != entry.size   ||
+	    (i > 0 && name_at(entry) < name_at(sorted[i - 1])))
+	{
+	    return false;
+	}
+    }
+
+    // Probing stops only at an empty slot and wraps with a mask.
+    if (not hashed.empty() &&
+	(not std::has_single_bit(hashed.size()) ||
+	 std::find(hashed.begin(), hashed.end(), npos_id) == hashed.end()))
+    {
+	return false;
+    }
+
+    for (auto id : hashed)
+    {
+	if (not valid_id(id) || (id != npos_id && long_names[id].size == 0))
+	{
+	    return false;
+	}
+    }
+
+    // Children follow their parent and every label below the root is
+    // non-empty, so a walk always moves forward through the name.
+    for (std::size_t node = 0; node < trie.size(); ++node)
+    {
+	auto& entry = trie[node];
+
+	if (not in_names(entry.label_offset, entry.label_size) ||
+	    not valid_id(entry.terminal) ||
+	    not (valid_id(entry.unique) || entry.unique == ambiguous_id) ||
+	    std::uint64_t {entry.first_child} + entry.children > trie.size() ||
+	    (entry.children != 0 && entry.first_child <= node) ||
+	    (node != 0 && entry.label_size == 0))
+	{
+	    return false;
+	}
+    }
+
+    if ((strategy_ == lookup_strategy::hash && hashed.empty()) ||
+	(strategy_ == lookup_strategy::trie && trie.empty()))
+    {
+	return false;
+    }
+
+    // Bits past the last option would name ids that do not exist.
+    if (auto used = size % 64; used != 0)
+    {
+	auto unused = ~std::uint64_t {0} << used;
+
+	if ((required.back() & unused) != 0 || (arguments.back() & unused) != 0)
+	{
+	    return false;
+	}
+    }
+
+    return true;
+}
+
+bool grammar::save(const char* path) const
+{
+    auto file = serialize();
+
+    // Written aside and renamed, so a process loading the file at the
+    // same time sees either the old or the new one.
+    auto temporary = std::string {path}.append(".tmp");
+
+    {
+	std::ofstream stream {temporary, std::ios::binary | std::ios::trunc};
+
+	stream.write(reinterpret_cast<const char*>(file.data()), file.size());
+
+	if (not stream.flush())
+	{
+	    std::remove(temporary.c_str());
+
+	    return false;
+	}
+    }
+
+    return std::rename(temporary.c_str(), path) == 0;
+}
+
+std::shared_ptr<const grammar>
+grammar::load(const char*                        path,
+	      std::span<const shared_dictionary> dictionaries,
+	      lookup_strategy                    strategy)
+{
+    if (dictionaries.empty())
+    {
+	return compile(dictionaries, strategy);
+    }
+
+    auto map = [&]() -> std::shared_ptr<const grammar>
+    {
+	std::shared_ptr<const void> mapping;
+
+	auto file = map_file(path, mapping);
+
+	file_header header;
+
+	if (file.size() < sizeof(header))
+	{
+	    return nullptr;
+	}
+
+	std::memcpy(&header, file.data(), sizeof(header));
+
+	if (header.magic   != file_header::magic_value   ||
+	    header.version != file_header::version_value ||
+	    header.layout  != file_header::layout_value  ||
+	    header.requested != static_cast<std::uint8_t>(strategy) ||
+	    header.strategy  >  static_cast<std::uint8_t>(lookup_strategy::trie))
+	{
+	    return nullptr;
+	}
+
+	struct element final
+	{
+	    std::size_t size;
+	    std::size_t alignment;
+	};
+
+	const element elements[] = {
+	    {sizeof(std::uint32_t), alignof(std::uint32_t)},
+	    {sizeof(char),          alignof(char)},
+	    {sizeof(unsigned char), alignof(unsigned char)},
+	    {sizeof(name),          alignof(name)},
+	    {sizeof(sorted_name),   alignof(sorted_name)},
+	    {sizeof(std::uint32_t), alignof(std::uint32_t)},
+	    {sizeof(trie_node),     alignof(trie_node)},
+	    {sizeof(std::uint64_t), alignof(std::uint64_t)},
+	    {sizeof(std::uint64_t), alignof(std::uint64_t)},
+	    {sizeof(std::uint32_t), alignof(std::uint32_t)}
+	};
+
+	for (std::size_t i = 0; i < file_header::table_count; ++i)
+	{
+	    auto& section = header.sections[i];
+
+	    if (section.offset % elements[i].alignment != 0 ||
+		section.offset > file.size() ||
+		section.size > (file.size() - section.offset) / elements[i].size)
+	    {
+		return nullptr;
+	    }
+	}
+
+	std::vector<const option*> options;
+
+	std::uint64_t fingerprint = cli::generic::fnv1a_offset_basis;
+
+	for (auto&& dictionary : dictionaries)
+	{
+	    for (auto&& option : dictionary)
+	    {
+		options.emplace_back(&option);
+
+		fingerprint = grammar::fingerprint(fingerprint, option);
+	    }
+	}
+
+	auto words = (options.size() + 63) / 64;
+
+	auto& sections = header.sections;
+
+	if (header.fingerprint != fingerprint ||
+	    header.options     != options.size() ||
+	    sections[file_header::short_table_table].size != 256 ||
+	    sections[file_header::short_names_table].size != options.size() ||
+	    sections[file_header::long_names_table].size  != options.size() ||
+	    sections[file_header::required_table].size    != words ||
+	    sections[file_header::arguments_table].size   != words)
+	{
+	    return nullptr;
+	}
+
+	std::shared_ptr<const grammar> loaded {
+	    new grammar {
+		dictionaries, strategy, std::move(options), mapping, header
+	    }
+	};
+
+	if (not loaded->valid_tables())
+	{
+	    return nullptr;
+	}
+
+	// Options with equality validators are not in the name tables, so
+	// they must be the same options the file was written for.
+	auto validated = loaded->validated.begin();
+
+	for (std::uint32_t id = 0, size = loaded->size(); id < size; ++id)
+	{
+	    if ((*loaded)[id].has_equality_validator() !=
+		(validated != loaded->validated.end() && *validated == id))
+	    {
+		return nullptr;
+	    }
+
+	    if ((*loaded)[id].has_equality_validator())
+	    {
+		++validated;
+	    }
+	}
+
+	if (validated != loaded->validated.end())
+	{
+	    return nullptr;
+	}
+
+#ifdef CHECK_LOOKUP_STRATEGIES
+	if (loaded->hashed.empty() || loaded->trie.empty())
+	{
+	    return nullptr;
+	}
+#endif
+
+	return loaded;
+    };
+
+    return intern(dictionaries, strategy, [&]
+    {
+	if (auto loaded = map())
+	{
+	    return loaded;
+	}
+
+	return std::shared_ptr<const grammar> {
+	    new grammar {dictionaries, strategy}
+	};
+    });
+}
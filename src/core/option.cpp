@@ -9,6 +9,8 @@
 #include "error/invalid_format_for_short_option_name.hpp"
 #include "error/invalid_format_for_long_option_name.hpp"
 
+#include "generic/error_handler.hpp"
+
 using namespace cli::core;
 
 option::option(
@@ -30,25 +32,25 @@ option::option(
 {
     if (not (short_name.empty() || is_short_option_name(short_name)))
     {
-	throw error::invalid_format_for_short_option_name {
+	generic::raise(error::invalid_format_for_short_option_name {
 	    short_name,
 	    EXCEPTION_SOURCE_INFORMATION
-	};
+	});
     }
 
     if (not (long_name.empty() || is_long_option_name(long_name)))
     {
-	throw error::invalid_format_for_long_option_name {
+	generic::raise(error::invalid_format_for_long_option_name {
 	    long_name,
 	    EXCEPTION_SOURCE_INFORMATION
-	};
+	});
     }
 
     if (short_name.empty() && long_name.empty())
     {
-	throw error::option_must_have_at_least_short_or_long_name {
+	generic::raise(error::option_must_have_at_least_short_or_long_name {
 	    EXCEPTION_SOURCE_INFORMATION
-	};
+	});
     }
 }
 
@@ -89,9 +91,9 @@ void option::short_name(std::string_view other)
 {
     if (other.empty() && long_name_.empty())
     {
-	throw error::option_must_have_at_least_short_or_long_name {
+	generic::raise(error::option_must_have_at_least_short_or_long_name {
 	    EXCEPTION_SOURCE_INFORMATION
-	};
+	});
     }
 
     if (other.empty() || is_short_option_name(other))
@@ -101,10 +103,10 @@ void option::short_name(std::string_view other)
 
     else
     {
-	throw error::invalid_format_for_short_option_name {
+	generic::raise(error::invalid_format_for_short_option_name {
 	    other,
 	    EXCEPTION_SOURCE_INFORMATION
-	};
+	});
     }
 }
 
@@ -112,9 +114,9 @@ void option::long_name(std::string_view other)
 {
     if (other.empty() && short_name_.empty())
     {
-	throw error::option_must_have_at_least_short_or_long_name {
+	generic::raise(error::option_must_have_at_least_short_or_long_name {
 	    EXCEPTION_SOURCE_INFORMATION
-	};
+	});
     }
 
     if (other.empty() || is_long_option_name(other))
@@ -124,9 +126,9 @@ void option::long_name(std::string_view other)
 
     else
     {
-	throw error::invalid_format_for_long_option_name {
+	generic::raise(error::invalid_format_for_long_option_name {
 	    other,
 	    EXCEPTION_SOURCE_INFORMATION
-	};
+	});
     }
 }
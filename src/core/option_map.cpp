@@ -1,37 +1,80 @@
 #include <string_view>
+#include <algorithm>
+#include <cstddef>
+#include <chrono>
 #include <string>
 #include <vector>
+#include <span>
 
 #include "configuration/exception_source_information.hpp"
+#include "configuration/instrumentation.hpp"
+#include "configuration/tracing.hpp"
 
+#include "core/parse_stats.hpp"
 #include "core/option_map.hpp"
 #include "core/option.hpp"
 #include "core/parser.hpp"
 
 #include "error/accessing_option_without_arguments.hpp"
 #include "error/accessing_option_not_yet_added.hpp"
+#include "error/argument_without_option.hpp"
 #include "error/unrecognized_option.hpp"
 
+#include "generic/error_handler.hpp"
+
 using namespace cli::core;
 
 void
-option_map::add_command_line_options(const parser::parsed_command_line& options)
+option_map::add_command_line_options(std::span<const std::string_view> options)
 {
+    INSTRUMENT(
+	stats_ = {};
+
+	auto start = std::chrono::steady_clock::now();
+    )
+
+    // An argument belongs to the option before it, so a span cannot
+    // start with one.
+    if (not options.empty() && not is_option_name(options.front()))
+    {
+	generic::raise(error::argument_without_option {
+	    options.front(),
+	    EXCEPTION_SOURCE_INFORMATION
+	});
+    }
+
+    TRACEPOINT(map__build__start, options.size());
+
+    std::size_t position = 0;
+
     for (int i = 0, size = options.size(); i < size; ++i)
     {
+	INSTRUMENT(++stats_.tokens;)
+
 	if (is_option_name(options[i]))
 	{
-	    add_option(options[i]);
+	    position = add_option(options[i]);
 	}
 
 	else
 	{
-	    add_option_argument(options[i - 1], options[i]);
+	    add_option_argument(position, options[i]);
 	}
     }
+
+    TRACEPOINT(map__build__end, map.size());
+
+    INSTRUMENT(
+	stats_.map_build = std::chrono::steady_clock::now() - start;
+
+	if (stats_hook_)
+	{
+	    stats_hook_(stats_);
+	}
+    )
 }
 
-void option_map::add_option(std::string_view option_name)
+std::size_t option_map::add_option(std::string_view option_name)
 {
     std::string_view key = option_name;
     std::string_view value;
@@ -44,26 +87,90 @@ void option_map::add_option(std::string_view option_name)
 	value = option_name.substr(++position);
     }
 
-    if (not contains(key))
+    auto id = compiled->find_abbreviated(key INSTRUMENT(, &stats_));
+
+    // Options of the grammar are kept under their canonical name, so an
+    // abbreviation and the full name land in one entry. Names accepted by
+    // an equality validator carry meaning of their own, and unknown or
+    // ambiguous names have no option, so those are kept as given.
+    if (id >= compiled->size())
     {
-	map.emplace_back(value_type {key, {}});
+	id = grammar::npos;
     }
 
-    if (not value.empty())
+    else if (auto& option = (*compiled)[id];
+	     not option.has_equality_validator())
     {
-	auto arguments = split_arguments(value);
+	key = option.long_name().empty() ?
+	    option.short_name() :
+	    option.long_name();
+    }
 
-	for (auto&& argument : arguments)
-	{
-	    add_option_argument(key, argument);
-	}
+    auto position = find_entry(id, key);
+
+    INSTRUMENT(
+	++stats_.lookups;
+
+	stats_.comparisons += std::min(position + 1, ids.size());
+    )
+
+    if (position == ids.size())
+    {
+	INSTRUMENT(
+	    stats_.estimate_allocation(map);
+	    stats_.estimate_allocation(ids);
+	)
+
+	map.emplace_back(value_type {key, {}});
+
+	ids.emplace_back(id);
     }
+
+    TRACEPOINT(map__option, position, id);
+
+    for_each_argument(value, [&](std::string_view argument)
+    {
+	add_option_argument(position, argument);
+    });
+
+    return position;
 }
 
 void option_map::add_option_argument(
-    std::string_view option_name, std::string_view option_argument)
+    std::size_t position, std::string_view option_argument)
+{
+    INSTRUMENT(stats_.estimate_allocation(map[position].second);)
+
+    map[position].second.emplace_back(option_argument);
+}
+
+std::vector<grammar::size_type>
+option_map::changed_options(const option_map& other) const
 {
-    get_option_arguments(option_name).emplace_back(option_argument);
+    std::vector<grammar::size_type> changed;
+
+    for (std::size_t i = 0; i < ids.size(); ++i)
+    {
+	auto position = other.find_entry(ids[i], map[i].first);
+
+	if (position == other.ids.size() ||
+	    other.map[position].second != map[i].second)
+	{
+	    changed.emplace_back(ids[i]);
+	}
+    }
+
+    for (std::size_t i = 0; i < other.ids.size(); ++i)
+    {
+	if (find_entry(other.ids[i], other.map[i].first) == ids.size())
+	{
+	    changed.emplace_back(other.ids[i]);
+	}
+    }
+
+    std::sort(changed.begin(), changed.end());
+
+    return changed;
 }
 
 const option_map::mapped_type&
@@ -76,30 +183,30 @@ option_map::operator[](const option& option) const
 	    return it->second;
 	}
 
-	throw error::accessing_option_without_arguments {
+	generic::raise(error::accessing_option_without_arguments {
 	    option.short_name().empty() ?
 	    option.long_name() :
 	    option.short_name(),
 	    EXCEPTION_SOURCE_INFORMATION
-	};
+	});
     }
 
     if (dictionary_contains_option(option))
     {
-	throw error::accessing_option_not_yet_added {
+	generic::raise(error::accessing_option_not_yet_added {
 	    option.short_name().empty() ?
 	    option.long_name() :
 	    option.short_name(),
 	    EXCEPTION_SOURCE_INFORMATION
-	};
+	});
     }
 
-    throw error::unrecognized_option {
+    generic::raise(error::unrecognized_option {
 	option.short_name().empty() ?
 	option.long_name() :
 	option.short_name(),
 	EXCEPTION_SOURCE_INFORMATION
-    };
+    });
 }
 
 const option_map::mapped_type&
@@ -112,54 +219,36 @@ option_map::operator[](std::string_view option_name) const
 	    return it->second;
 	}
 
-	throw error::accessing_option_without_arguments {
+	generic::raise(error::accessing_option_without_arguments {
 	    option_name,
 	    EXCEPTION_SOURCE_INFORMATION
-	};
+	});
     }
 
     if (dictionary_contains_option(option_name))
     {
-	throw error::accessing_option_not_yet_added {
+	generic::raise(error::accessing_option_not_yet_added {
 	    option_name,
 	    EXCEPTION_SOURCE_INFORMATION
-	};
+	});
     }
 
-    throw error::unrecognized_option {
+    generic::raise(error::unrecognized_option {
 	option_name,
         EXCEPTION_SOURCE_INFORMATION
-    };
+    });
 }
 
-std::vector<std::string_view>
-option_map::split_arguments(std::string_view option_argument)
+option_map::mapped_type
+option_map::split_arguments(std::string_view option_argument,
+			    const allocator_type& allocator)
 {
-    std::vector<std::string_view> arguments;
+    mapped_type arguments {allocator};
 
-    for (int i = 0, size = option_argument.size(); i < size; ++i)
+    for_each_argument(option_argument, [&](std::string_view argument)
     {
-	while (i < size && option_argument[i] == ',')
-	{
-	    ++i;
-	}
-
-	int first = i++;
-
-	while (i < size && option_argument[i] != ',')
-	{
-	    ++i;
-	}
-
-	int last = i;
-
-	auto argument = option_argument.substr(first, last - first);
-
-	if (not argument.empty())
-	{
-	    arguments.emplace_back(argument);
-	}
-    }
+	arguments.emplace_back(argument);
+    });
 
     return arguments;
 }
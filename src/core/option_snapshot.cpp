@@ -0,0 +1,425 @@
+#include <initializer_list>
+#include <string_view>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <bit>
+
+#include "configuration/exception_source_information.hpp"
+
+#include "core/shared_dictionary.hpp"
+#include "core/option_snapshot.hpp"
+#include "core/option_map.hpp"
+#include "core/grammar.hpp"
+#include "core/option.hpp"
+
+#include "error/accessing_option_without_arguments.hpp"
+#include "error/accessing_option_not_yet_added.hpp"
+#include "error/unrecognized_option.hpp"
+#include "error/invalid_snapshot.hpp"
+
+#include "generic/error_handler.hpp"
+
+using namespace cli::core;
+
+namespace
+{
+    class blob_writer final
+    {
+    public:
+
+	explicit blob_writer(std::size_t size) :
+	    blob (size)
+	{}
+
+	template<typename T>
+	void store(T value) noexcept
+	{
+	    std::memcpy(blob.data() + position, &value, sizeof(value));
+
+	    position += sizeof(value);
+	}
+
+	void store(std::string_view bytes) noexcept
+	{
+	    std::memcpy(blob.data() + position, bytes.data(), bytes.size());
+
+	    position += bytes.size();
+	}
+
+	std::vector<std::byte> blob;
+
+	std::size_t position = 0;
+    };
+
+    std::shared_ptr<const grammar>
+    compile(std::initializer_list<dictionary> dictionaries)
+    {
+	std::vector<shared_dictionary> shared (
+	    dictionaries.begin(), dictionaries.end());
+
+	return grammar::compile(shared);
+    }
+
+    [[noreturn]] void invalid(std::string_view reason)
+    {
+	cli::generic::raise(cli::error::invalid_snapshot {
+	    reason,
+	    EXCEPTION_SOURCE_INFORMATION
+	});
+    }
+}
+
+option_snapshot::option_snapshot(std::span<const std::byte> blob,
+				 std::initializer_list<dictionary> dictionaries) :
+    option_snapshot {blob, compile(dictionaries)}
+{}
+
+option_snapshot::option_snapshot(std::span<const std::byte> blob,
+				 const option_map& prototype) :
+    option_snapshot {blob, prototype.compiled}
+{}
+
+option_snapshot::option_snapshot(std::span<const std::byte> blob,
+				 std::shared_ptr<const grammar> compiled) :
+    blob     {blob},
+    compiled {std::move(compiled)}
+{
+    if (blob.size() < header_size)
+    {
+	invalid("truncated header");
+    }
+
+    const std::byte* header = blob.data();
+
+    if (load<std::uint32_t>(header) != magic ||
+	load<std::uint32_t>(header + 4) != version)
+    {
+	invalid("unknown format");
+    }
+
+    std::size_t options = load<std::uint32_t>(header + 16);
+
+    if (load<std::uint64_t>(header + 8) != this->compiled->fingerprint() ||
+	options != this->compiled->size())
+    {
+	invalid("grammar mismatch");
+    }
+
+    std::size_t arguments = load<std::uint32_t>(header + 24);
+    std::size_t byte_size = load<std::uint32_t>(header + 28);
+
+    words = (options + 63) / 64;
+    size_ = load<std::uint32_t>(header + 20);
+
+    std::size_t ranks_offset   = header_size + words * sizeof(std::uint64_t);
+    std::size_t entries_offset = ranks_offset + words * sizeof(std::uint32_t);
+    std::size_t records_offset = entries_offset + size_ * entry_record_size;
+    std::size_t bytes_offset   =
+	records_offset + arguments * argument_record_size;
+
+    if (bytes_offset + byte_size != blob.size())
+    {
+	invalid("size mismatch");
+    }
+
+    presence = header + header_size;
+    ranks    = header + ranks_offset;
+    entries  = header + entries_offset;
+    records  = header + records_offset;
+    bytes    = reinterpret_cast<const char*>(header + bytes_offset);
+
+    // Every offset is checked once here, so lookups can trust them.
+    std::size_t rank = 0;
+
+    for (std::size_t word = 0; word < words; ++word)
+    {
+	if (load<std::uint32_t>(ranks + word * sizeof(std::uint32_t)) != rank)
+	{
+	    invalid("corrupt presence");
+	}
+
+	rank += std::popcount(
+	    load<std::uint64_t>(presence + word * sizeof(std::uint64_t)));
+    }
+
+    if (rank != size_)
+    {
+	invalid("corrupt presence");
+    }
+
+    for (std::size_t entry = 0; entry < size_; ++entry)
+    {
+	auto record = entries + entry * entry_record_size;
+
+	std::size_t id             = load<std::uint32_t>(record);
+	std::size_t key_offset     = load<std::uint32_t>(record + 4);
+	std::size_t key_size       = load<std::uint32_t>(record + 8);
+	std::size_t first_argument = load<std::uint32_t>(record + 12);
+	std::size_t argument_count = load<std::uint32_t>(record + 16);
+
+	if (id >= options || find_entry(id) != entry ||
+	    key_offset + key_size > byte_size ||
+	    first_argument + argument_count > arguments)
+	{
+	    invalid("corrupt entry");
+	}
+    }
+
+    for (std::size_t argument = 0; argument < arguments; ++argument)
+    {
+	auto record = records + argument * argument_record_size;
+
+	std::size_t offset = load<std::uint32_t>(record);
+	std::size_t size   = load<std::uint32_t>(record + 4);
+
+	if (offset + size > byte_size)
+	{
+	    invalid("corrupt argument");
+	}
+    }
+}
+
+std::vector<std::byte> option_snapshot::write(const option_map& map)
+{
+    const grammar& compiled = *map.compiled;
+
+    std::size_t words = (compiled.size() + 63) / 64;
+
+    std::vector<std::size_t> order;
+
+    for (std::size_t i = 0; i < map.ids.size(); ++i)
+    {
+	if (map.ids[i] < compiled.size())
+	{
+	    order.emplace_back(i);
+	}
+    }
+
+    std::sort(order.begin(), order.end(), [&](auto lhs, auto rhs)
+    {
+	return map.ids[lhs] < map.ids[rhs];
+    });
+
+    std::size_t arguments = 0;
+    std::size_t byte_size = 0;
+
+    for (auto i : order)
+    {
+	byte_size += map.map[i].first.size();
+
+	for (auto&& argument : map.map[i].second)
+	{
+	    byte_size += argument.size();
+	}
+
+	arguments += map.map[i].second.size();
+    }
+
+    if (byte_size > std::numeric_limits<std::uint32_t>::max())
+    {
+	invalid("arguments too large");
+    }
+
+    blob_writer writer {
+	header_size +
+	words * (sizeof(std::uint64_t) + sizeof(std::uint32_t)) +
+	order.size() * entry_record_size +
+	arguments * argument_record_size +
+	byte_size
+    };
+
+    writer.store(magic);
+    writer.store(version);
+    writer.store(compiled.fingerprint());
+    writer.store(static_cast<std::uint32_t>(compiled.size()));
+    writer.store(static_cast<std::uint32_t>(order.size()));
+    writer.store(static_cast<std::uint32_t>(arguments));
+    writer.store(static_cast<std::uint32_t>(byte_size));
+
+    std::vector<std::uint64_t> presence (words);
+
+    for (auto i : order)
+    {
+	grammar::set(presence, map.ids[i]);
+    }
+
+    for (auto word : presence)
+    {
+	writer.store(word);
+    }
+
+    std::uint32_t rank = 0;
+
+    for (auto word : presence)
+    {
+	writer.store(rank);
+
+	rank += std::popcount(word);
+    }
+
+    std::uint32_t first_argument = 0;
+    std::uint32_t offset         = 0;
+
+    for (auto i : order)
+    {
+	auto&& [key, values] = map.map[i];
+
+	writer.store(static_cast<std::uint32_t>(map.ids[i]));
+	writer.store(offset);
+	writer.store(static_cast<std::uint32_t>(key.size()));
+	writer.store(first_argument);
+	writer.store(static_cast<std::uint32_t>(values.size()));
+
+	offset         += key.size();
+	first_argument += values.size();
+
+	for (auto&& argument : values)
+	{
+	    offset += argument.size();
+	}
+    }
+
+    offset = 0;
+
+    for (auto i : order)
+    {
+	auto&& [key, values] = map.map[i];
+
+	offset += key.size();
+
+	for (auto&& argument : values)
+	{
+	    writer.store(offset);
+	    writer.store(static_cast<std::uint32_t>(argument.size()));
+
+	    offset += argument.size();
+	}
+    }
+
+    for (auto i : order)
+    {
+	auto&& [key, values] = map.map[i];
+
+	writer.store(key);
+
+	for (auto&& argument : values)
+	{
+	    writer.store(argument);
+	}
+    }
+
+    return std::move(writer.blob);
+}
+
+bool option_snapshot::contains(const option& option) const noexcept
+{
+    auto id = compiled->find(
+	option.short_name().empty() ? option.long_name() : option.short_name());
+
+    return id != grammar::npos && find_entry(id) != npos;
+}
+
+std::optional<std::string_view>
+option_snapshot::contains(std::string_view option_name) const noexcept
+{
+    if (auto id = compiled->find(option_name); id != grammar::npos)
+    {
+	if (auto entry = find_entry(id); entry != npos)
+	{
+	    return key(entry);
+	}
+    }
+
+    return {};
+}
+
+option_snapshot::argument_list
+option_snapshot::operator[](const option& option) const
+{
+    auto option_name =
+	option.short_name().empty() ? option.long_name() : option.short_name();
+
+    return checked_arguments(compiled->find(option_name), option_name);
+}
+
+option_snapshot::argument_list
+option_snapshot::operator[](std::string_view option_name) const
+{
+    return checked_arguments(compiled->find(option_name), option_name);
+}
+
+std::size_t option_snapshot::find_entry(grammar::size_type id) const noexcept
+{
+    auto word = id / 64;
+    auto bits = load<std::uint64_t>(presence + word * sizeof(std::uint64_t));
+    auto mask = std::uint64_t {1} << (id % 64);
+
+    if (not (bits & mask))
+    {
+	return npos;
+    }
+
+    return load<std::uint32_t>(ranks + word * sizeof(std::uint32_t)) +
+	std::popcount(bits & (mask - 1));
+}
+
+std::string_view option_snapshot::key(std::size_t entry) const noexcept
+{
+    auto record = entries + entry * entry_record_size;
+
+    return {
+	bytes + load<std::uint32_t>(record + 4),
+	load<std::uint32_t>(record + 8)
+    };
+}
+
+option_snapshot::argument_list
+option_snapshot::arguments(std::size_t entry) const noexcept
+{
+    auto record = entries + entry * entry_record_size;
+
+    return {
+	records + load<std::uint32_t>(record + 12) * argument_record_size,
+	bytes,
+	load<std::uint32_t>(record + 16)
+    };
+}
+
+option_snapshot::argument_list
+option_snapshot::checked_arguments(grammar::size_type id,
+				   std::string_view   option_name) const
+{
+    if (id == grammar::npos)
+    {
+	generic::raise(error::unrecognized_option {
+	    option_name,
+	    EXCEPTION_SOURCE_INFORMATION
+	});
+    }
+
+    auto entry = find_entry(id);
+
+    if (entry == npos)
+    {
+	generic::raise(error::accessing_option_not_yet_added {
+	    option_name,
+	    EXCEPTION_SOURCE_INFORMATION
+	});
+    }
+
+    if (not compiled->has_arguments(id))
+    {
+	generic::raise(error::accessing_option_without_arguments {
+	    option_name,
+	    EXCEPTION_SOURCE_INFORMATION
+	});
+    }
+
+    return arguments(entry);
+}
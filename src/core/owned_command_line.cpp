@@ -0,0 +1,77 @@
+#include <string_view>
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <span>
+
+#include "core/owned_command_line.hpp"
+
+using namespace cli::core;
+
+owned_command_line::owned_command_line(
+    std::span<const std::string_view> options,
+    std::span<const std::string_view> positional_options,
+    const allocator_type&             allocator)
+    :
+    storage {allocator}
+{
+    std::size_t views = options.size() + positional_options.size();
+    std::size_t bytes = 0;
+
+    for (auto&& view : options)
+    {
+	bytes += view.size();
+    }
+
+    for (auto&& view : positional_options)
+    {
+	bytes += view.size();
+    }
+
+    if (views == 0)
+    {
+	return;
+    }
+
+    storage.allocate(views * sizeof(std::string_view) + bytes,
+		     alignof(std::string_view));
+
+    auto* first = static_cast<std::string_view*>(storage.data());
+    auto* text  = reinterpret_cast<char*>(first + views);
+    auto* view  = first;
+
+    auto copy = [&](std::span<const std::string_view> source)
+    {
+	for (auto&& token : source)
+	{
+	    std::copy(token.begin(), token.end(), text);
+
+	    *view++ = {text, token.size()};
+
+	    text += token.size();
+	}
+    };
+
+    copy(options);
+    copy(positional_options);
+
+    options_    = {first, options.size()};
+    positional_ = {first + options.size(), positional_options.size()};
+}
+
+owned_command_line&
+owned_command_line::operator=(owned_command_line&& other)
+{
+    if (this != &other)
+    {
+	if (not storage.take_over(other.storage))
+	{
+	    return *this = static_cast<const owned_command_line&>(other);
+	}
+
+	options_    = std::exchange(other.options_, {});
+	positional_ = std::exchange(other.positional_, {});
+    }
+
+    return *this;
+}
@@ -0,0 +1,189 @@
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include <mutex>
+
+#include "core/parse_cache.hpp"
+#include "core/option_map.hpp"
+#include "core/parser.hpp"
+
+#include "generic/hash.hpp"
+
+using namespace cli::core;
+
+namespace
+{
+    // The tokens before the first null entry, which ends argv for the
+    // parser as well.
+    int token_count(int argc, const char** argv) noexcept
+    {
+	for (int i = 0; i < argc; ++i)
+	{
+	    if (argv[i] == nullptr)
+	    {
+		return i;
+	    }
+	}
+
+	return argc;
+    }
+}
+
+parse_result::parse_result(const parser&     parser_prototype,
+			   const option_map& map_prototype,
+			   int               argc,
+			   const char**      argv) :
+    argc     {token_count(argc, argv)},
+    options_ {map_prototype}
+{
+    std::vector<std::size_t> offsets;
+
+    offsets.reserve(this->argc);
+
+    for (int i = 0; i < this->argc; ++i)
+    {
+	offsets.emplace_back(bytes.size());
+
+	bytes.append(argv[i]);
+	bytes.push_back('\0');
+    }
+
+    std::vector<const char*> tokens;
+
+    tokens.reserve(this->argc + 1);
+
+    for (auto offset : offsets)
+    {
+	tokens.emplace_back(bytes.data() + offset);
+    }
+
+    tokens.emplace_back(nullptr);
+
+    parser parser {parser_prototype};
+
+    parser.parse_command_line(this->argc, tokens.data());
+
+    options_.add_command_line_options(parser.options());
+
+    positional_options_.assign(
+	parser.positional_options().begin(),
+	parser.positional_options().end());
+}
+
+bool parse_result::matches(int argc, const char** argv) const noexcept
+{
+    argc = token_count(argc, argv);
+
+    if (argc != this->argc)
+    {
+	return false;
+    }
+
+    std::string_view rest = bytes;
+
+    for (int i = 0; i < argc; ++i)
+    {
+	std::string_view token = argv[i];
+
+	if (rest.size() <= token.size() ||
+	    rest.substr(0, token.size()) != token ||
+	    rest[token.size()] != '\0')
+	{
+	    return false;
+	}
+
+	rest.remove_prefix(token.size() + 1);
+    }
+
+    return rest.empty();
+}
+
+std::uint64_t parse_result::hash(int argc, const char** argv) noexcept
+{
+    argc = token_count(argc, argv);
+
+    std::uint64_t hash = argc;
+
+    for (int i = 0; i < argc; ++i)
+    {
+	hash = generic::fast_hash(hash, argv[i]);
+    }
+
+    return hash;
+}
+
+parse_cache::parse_cache(std::initializer_list<dictionary> dictionaries,
+			 std::size_t                       capacity) :
+    parser_prototype {dictionaries},
+    map_prototype    {dictionaries},
+    capacity_        {capacity}
+{}
+
+std::shared_ptr<const parse_result>
+parse_cache::parse(int argc, const char** argv)
+{
+    auto hash = parse_result::hash(argc, argv);
+
+    {
+	std::scoped_lock lock {mutex};
+
+	if (auto it = index.find(hash); it != index.end())
+	{
+	    if (it->second->result->matches(argc, argv))
+	    {
+		++stats_.hits;
+
+		entries.splice(entries.begin(), entries, it->second);
+
+		return it->second->result;
+	    }
+
+	    ++stats_.collisions;
+	}
+
+	++stats_.misses;
+    }
+
+    // Parsed outside the lock, so one long command line does not hold up
+    // hits on other threads.
+    auto result = std::make_shared<const parse_result>(
+	parser_prototype, map_prototype, argc, argv);
+
+    if (capacity_ == 0)
+    {
+	return result;
+    }
+
+    std::scoped_lock lock {mutex};
+
+    if (auto it = index.find(hash); it != index.end())
+    {
+	entries.erase(it->second);
+	index.erase(it);
+    }
+
+    else if (entries.size() == capacity_)
+    {
+	index.erase(entries.back().hash);
+	entries.pop_back();
+
+	++stats_.evictions;
+    }
+
+    entries.push_front(entry {hash, result});
+
+    index.emplace(hash, entries.begin());
+
+    return result;
+}
+
+void parse_cache::clear()
+{
+    std::scoped_lock lock {mutex};
+
+    entries.clear();
+    index.clear();
+}
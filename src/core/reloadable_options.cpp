@@ -0,0 +1,81 @@
+#include <initializer_list>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <mutex>
+
+#include "core/reloadable_options.hpp"
+#include "core/shared_dictionary.hpp"
+#include "core/option_map.hpp"
+#include "core/grammar.hpp"
+#include "core/parser.hpp"
+
+using namespace cli::core;
+
+reloadable_options::reloadable_options(
+    std::initializer_list<dictionary> dictionaries) :
+    parser_prototype {dictionaries},
+    map_prototype    {dictionaries},
+    compiled         {
+	grammar::compile(
+	    std::vector<shared_dictionary> (
+		dictionaries.begin(), dictionaries.end()))
+    },
+    current          {new snapshot {parser_prototype, map_prototype}}
+{}
+
+reloadable_options::reader reloadable_options::read() const noexcept
+{
+    // A reader counted under an epoch that has already been left could
+    // be missed by the reload waiting on it, so the epoch is checked again
+    // once the reader is counted.
+    for (;;)
+    {
+	auto  observed = epoch.load();
+	auto& counter  = readers[observed & 1];
+
+	counter.fetch_add(1);
+
+	if (epoch.load() == observed)
+	{
+	    return reader {current.load(), &counter};
+	}
+
+	if (counter.fetch_sub(1) == 1)
+	{
+	    counter.notify_all();
+	}
+    }
+}
+
+std::vector<grammar::size_type>
+reloadable_options::reload(int argc, const char** argv)
+{
+    parser parser {parser_prototype};
+
+    parser.parse_command_line(argc, argv);
+
+    auto next = std::make_unique<const snapshot>(parser, map_prototype);
+
+    std::scoped_lock lock {writer};
+
+    const snapshot* previous = current.load();
+
+    auto changed = next->map.changed_options(previous->map);
+
+    current.store(next.release());
+
+    // Readers from here on count under the next epoch and see the new
+    // snapshot; once the previous epoch drains, nobody holds the old one.
+    auto& counter = readers[epoch.fetch_add(1) & 1];
+
+    for (auto count = counter.load(); count != 0; count = counter.load())
+    {
+	counter.wait(count);
+    }
+
+    delete previous;
+
+    return changed;
+}
@@ -0,0 +1,182 @@
+#include <unordered_map>
+#include <string_view>
+#include <type_traits>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <mutex>
+
+#include "core/shared_dictionary.hpp"
+#include "core/dictionary.hpp"
+#include "core/option.hpp"
+
+#include "generic/hash.hpp"
+
+using namespace cli::core;
+
+namespace
+{
+    bool identical(const option& lhs, const option& rhs) noexcept
+    {
+	return (lhs.short_name()     == rhs.short_name()     &&
+		lhs.long_name()      == rhs.long_name()      &&
+		lhs.representation() == rhs.representation() &&
+		lhs.description()    == rhs.description()    &&
+		lhs.is_required()    == rhs.is_required()    &&
+		lhs.has_arguments()  == rhs.has_arguments()  &&
+		not lhs.has_equality_validator()             &&
+		not rhs.has_equality_validator());
+    }
+
+    bool identical(const dictionary& lhs, const dictionary& rhs) noexcept
+    {
+	return std::equal(lhs.cbegin(),
+			  lhs.cend(),
+			  rhs.cbegin(),
+			  rhs.cend(),
+			  [](auto&& lhs, auto&& rhs)
+			  {
+			      return identical(lhs, rhs);
+			  });
+    }
+
+    // Copies every string of the dictionary into one block and points the
+    // options at it.
+    std::unique_ptr<char[]> own_text(dictionary& dictionary)
+    {
+	std::size_t size = 0;
+
+	for (auto&& option : dictionary)
+	{
+	    size += (option.short_name().size()     +
+		     option.long_name().size()      +
+		     option.representation().size() +
+		     option.description().size());
+	}
+
+	auto text   = std::make_unique<char[]>(size);
+	auto cursor = text.get();
+
+	auto copy = [&](std::string_view other) -> std::string_view
+	{
+	    if (other.empty())
+	    {
+		return {};
+	    }
+
+	    std::string_view owned {cursor, other.size()};
+
+	    cursor = std::copy(other.cbegin(), other.cend(), cursor);
+
+	    return owned;
+	};
+
+	for (auto&& option : dictionary)
+	{
+	    auto short_name = copy(option.short_name());
+	    auto long_name  = copy(option.long_name());
+
+	    option.representation(copy(option.representation()));
+	    option.description(copy(option.description()));
+
+	    // The order keeps one of the names set at every step.
+	    if (short_name.empty())
+	    {
+		option.long_name(long_name);
+	    }
+
+	    else
+	    {
+		option.short_name(short_name);
+		option.long_name(long_name);
+	    }
+	}
+
+	return text;
+    }
+}
+
+std::uint64_t
+shared_dictionary::fingerprint(const dictionary& dictionary) noexcept
+{
+    std::uint64_t fingerprint = cli::generic::fnv1a_offset_basis;
+
+    for (auto&& option : dictionary)
+    {
+	fingerprint = cli::generic::fnv1a(fingerprint, option.short_name());
+	fingerprint = cli::generic::fnv1a(fingerprint, option.long_name());
+    }
+
+    return fingerprint;
+}
+
+template<typename Dictionary>
+std::shared_ptr<const shared_dictionary::shared_entry>
+shared_dictionary::intern(Dictionary&& dictionary)
+{
+    using registry =
+	std::unordered_multimap<std::uint64_t, std::weak_ptr<const shared_entry>>;
+
+    static std::mutex mutex;
+    static registry   entries;
+
+    auto fingerprint = shared_dictionary::fingerprint(dictionary);
+
+    std::scoped_lock lock {mutex};
+
+    auto [first, last] = entries.equal_range(fingerprint);
+
+    while (first != last)
+    {
+	if (auto entry = first->second.lock(); not entry)
+	{
+	    first = entries.erase(first);
+	}
+
+	else if (identical(entry->dictionary, dictionary))
+	{
+	    if constexpr (not std::is_lvalue_reference_v<Dictionary>)
+	    {
+		core::dictionary {}.swap(dictionary);
+	    }
+
+	    return entry;
+	}
+
+	else
+	{
+	    ++first;
+	}
+    }
+
+    core::dictionary contents {std::forward<Dictionary>(dictionary)};
+
+    auto text = own_text(contents);
+
+    std::shared_ptr<const shared_entry> entry {
+	new shared_entry {std::move(contents), std::move(text), fingerprint}
+    };
+
+    // Sweeping on every insertion bounds the registry by the live
+    // entries. Entries are allocated apart from their control blocks, so
+    // one that expires is freed at once and only its control block waits
+    // for the sweep.
+    std::erase_if(entries, [](auto&& interned)
+    {
+	return interned.second.expired();
+    });
+
+    entries.emplace(fingerprint, entry);
+
+    return entry;
+}
+
+shared_dictionary::shared_dictionary(const dictionary& dictionary) :
+    entry {intern(dictionary)}
+{}
+
+shared_dictionary::shared_dictionary(dictionary&& dictionary) :
+    entry {intern(std::move(dictionary))}
+{}
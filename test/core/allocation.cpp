@@ -0,0 +1,337 @@
+#define BOOST_TEST_MODULE allocation
+
+#include <memory_resource>
+#include <cstddef>
+#include <cstdlib>
+#include <utility>
+#include <array>
+#include <new>
+
+#include <boost/test/unit_test.hpp>
+
+#include "core/owned_command_line.hpp"
+#include "core/parser_policies.hpp"
+#include "core/dictionary.hpp"
+#include "core/option_map.hpp"
+#include "core/option.hpp"
+#include "core/parser.hpp"
+
+using namespace cli::core;
+
+namespace
+{
+    std::size_t allocations = 0;
+
+    struct allocation_counter final
+    {
+	allocation_counter() noexcept :
+	    first {allocations}
+	{}
+
+	std::size_t count() const noexcept
+	{
+	    return allocations - first;
+	}
+
+	std::size_t first;
+    };
+
+    struct counting_resource final : std::pmr::memory_resource
+    {
+	void* do_allocate(std::size_t bytes, std::size_t alignment) override
+	{
+	    ++allocations;
+
+	    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+	}
+
+	void do_deallocate(void* pointer, std::size_t bytes,
+			   std::size_t alignment) override
+	{
+	    std::pmr::new_delete_resource()->deallocate(
+		pointer, bytes, alignment);
+	}
+
+	bool do_is_equal(const memory_resource& other) const noexcept override
+	{
+	    return this == &other;
+	}
+
+	std::size_t allocations = 0;
+    };
+
+    const dictionary interfaces {
+	option {"-h", "--help"},
+
+	option {
+	    "-i",
+	    "--interface",
+	    {},
+	    {},
+	    option::required::not_required,
+	    option::arguments::has_arguments
+	},
+
+	option {
+	    "-o",
+	    "--output",
+	    {},
+	    {},
+	    option::required::not_required,
+	    option::arguments::has_arguments
+	}
+    };
+
+    const char* argv[] = {
+	"",
+	"-h",
+	"--interface=wlan0,vmnet1,,ppp0",
+	"-o",
+	"a.dat",
+	"data.dat",
+	"--output",
+	"b.dat",
+	nullptr
+    };
+}
+
+void* operator new(std::size_t size)
+{
+    ++allocations;
+
+    if (void* pointer = std::malloc(size == 0 ? 1 : size))
+    {
+	return pointer;
+    }
+
+    throw std::bad_alloc {};
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+BOOST_AUTO_TEST_SUITE(parser_allocations);
+
+BOOST_AUTO_TEST_CASE(reuse_parser)
+{
+    parser parser {interfaces};
+
+    parser.parse_command_line(std::size(argv), argv);
+
+    allocation_counter counter;
+
+    for (int i = 0; i < 8; ++i)
+    {
+	parser.parse_command_line(std::size(argv), argv);
+    }
+
+    BOOST_CHECK_EQUAL(counter.count(), 0);
+
+    BOOST_CHECK_EQUAL(parser.options().size(), 6);
+    BOOST_CHECK_EQUAL(parser.positional_options().size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(parse_into_arena)
+{
+    std::array<std::byte, 4096> buffer;
+
+    std::pmr::monotonic_buffer_resource arena {
+	buffer.data(), buffer.size(), std::pmr::null_memory_resource()
+    };
+
+    parser parser {{interfaces}, &arena};
+
+    BOOST_TEST(parser.get_allocator().resource() == &arena);
+    BOOST_TEST(parser.options().get_allocator().resource() == &arena);
+
+    allocation_counter counter;
+
+    parser.parse_command_line(std::size(argv), argv);
+
+    BOOST_CHECK_EQUAL(counter.count(), 0);
+
+    BOOST_CHECK_EQUAL(parser.options().size(), 6);
+}
+
+BOOST_AUTO_TEST_CASE(validate_without_allocating)
+{
+    const parser parser {interfaces};
+
+    allocation_counter counter;
+
+    auto diagnostic = parser.validate(std::size(argv), argv);
+
+    BOOST_CHECK_EQUAL(counter.count(), 0);
+
+    BOOST_TEST(not diagnostic.has_value());
+}
+
+BOOST_AUTO_TEST_CASE(parse_into_flat_storage)
+{
+    basic_parser<
+	automatic_lookup,
+	flat_storage<8>,
+	throw_errors,
+	std::allocator<std::byte>
+    > parser {interfaces};
+
+    allocation_counter counter;
+
+    parser.parse_command_line(std::size(argv), argv);
+
+    BOOST_CHECK_EQUAL(counter.count(), 0);
+
+    BOOST_CHECK_EQUAL(parser.options().size(), 6);
+    BOOST_CHECK_EQUAL(parser.positional_options().size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(own_command_line_in_one_allocation)
+{
+    parser parser {interfaces};
+
+    parser.parse_command_line(std::size(argv), argv);
+
+    counting_resource resource;
+
+    allocation_counter counter;
+
+    owned_command_line owned {parser, &resource};
+
+    owned_command_line moved {std::move(owned)};
+
+    BOOST_CHECK_EQUAL(counter.count(), 0);
+    BOOST_CHECK_EQUAL(resource.allocations, 1);
+
+    BOOST_CHECK_EQUAL(moved.options().size(), 6);
+    BOOST_CHECK_EQUAL(moved.positional_options().size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(move_parser_between_resources)
+{
+    counting_resource resource_1;
+    counting_resource resource_2;
+
+    parser source {{interfaces}, &resource_1};
+    parser target {&resource_2};
+
+    source.parse_command_line(std::size(argv), argv);
+
+    target = std::move(source);
+
+    BOOST_TEST(target.get_allocator().resource() == &resource_2);
+    BOOST_TEST(target.options().get_allocator().resource() == &resource_2);
+
+    BOOST_CHECK_EQUAL(target.options().size(), 6);
+    BOOST_CHECK_EQUAL(target.positional_options().size(), 1);
+
+    parser other {&resource_2};
+
+    other = std::move(target);
+
+    BOOST_CHECK_EQUAL(other.options().size(), 6);
+
+    BOOST_TEST(target.empty());
+    BOOST_TEST(target.options().empty());
+
+    other.parse_command_line(std::size(argv), argv);
+
+    BOOST_CHECK_EQUAL(other.options().size(), 6);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE(option_map_allocations);
+
+BOOST_AUTO_TEST_CASE(build_option_map_in_arena)
+{
+    parser parser {interfaces};
+
+    parser.parse_command_line(std::size(argv), argv);
+
+    const option_map prototype {interfaces};
+
+    std::array<std::byte, 4096> buffer;
+
+    std::size_t interfaces_size = 0;
+    std::size_t outputs_size    = 0;
+
+    allocation_counter counter;
+
+    for (int i = 0; i < 8; ++i)
+    {
+	std::pmr::monotonic_buffer_resource arena {
+	    buffer.data(), buffer.size(), std::pmr::null_memory_resource()
+	};
+
+	option_map map {prototype, &arena};
+
+	map.add_command_line_options(parser.options());
+
+	interfaces_size = map["--interface"].size();
+	outputs_size    = map["--output"].size();
+    }
+
+    BOOST_CHECK_EQUAL(counter.count(), 0);
+
+    BOOST_CHECK_EQUAL(interfaces_size, 3);
+    BOOST_CHECK_EQUAL(outputs_size,    2);
+}
+
+BOOST_AUTO_TEST_CASE(split_arguments_in_arena)
+{
+    std::array<std::byte, 1024> buffer;
+
+    std::pmr::monotonic_buffer_resource arena {
+	buffer.data(), buffer.size(), std::pmr::null_memory_resource()
+    };
+
+    allocation_counter counter;
+
+    auto arguments = option_map::split_arguments(",a,,b,c,", &arena);
+
+    BOOST_CHECK_EQUAL(counter.count(), 0);
+
+    BOOST_REQUIRE_EQUAL(arguments.size(), 3);
+
+    BOOST_CHECK_EQUAL(arguments[0], "a");
+    BOOST_CHECK_EQUAL(arguments[2], "c");
+}
+
+BOOST_AUTO_TEST_CASE(move_option_map_between_resources)
+{
+    parser parser {interfaces};
+
+    parser.parse_command_line(std::size(argv), argv);
+
+    counting_resource resource_1;
+    counting_resource resource_2;
+
+    option_map source {{interfaces}, &resource_1};
+    option_map target {&resource_2};
+
+    source.add_command_line_options(parser.options());
+
+    target = std::move(source);
+
+    BOOST_TEST(target.get_allocator().resource() == &resource_2);
+
+    BOOST_CHECK_EQUAL(target["--interface"].size(), 3);
+    BOOST_TEST(target["--interface"].get_allocator().resource() == &resource_2);
+
+    option_map other {&resource_2};
+
+    other = std::move(target);
+
+    BOOST_CHECK_EQUAL(other["--output"].size(), 2);
+
+    BOOST_TEST(target.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,72 @@
+#define BOOST_TEST_MODULE arena_storage
+
+#include <memory_resource>
+#include <utility>
+
+#include <boost/test/unit_test.hpp>
+
+#include "core/arena_storage.hpp"
+
+using namespace cli::core;
+
+BOOST_AUTO_TEST_SUITE(ownership);
+
+BOOST_AUTO_TEST_CASE(move_keeps_block)
+{
+    std::pmr::monotonic_buffer_resource resource;
+
+    arena_storage storage {&resource};
+
+    storage.allocate(64, alignof(void*));
+
+    auto* data = storage.data();
+
+    arena_storage moved {std::move(storage)};
+
+    BOOST_TEST(moved.data() == data);
+    BOOST_CHECK_EQUAL(moved.size(), 64);
+    BOOST_TEST(moved.get_allocator().resource() == &resource);
+
+    BOOST_TEST(storage.data() == nullptr);
+    BOOST_CHECK_EQUAL(storage.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(take_over_from_same_resource)
+{
+    std::pmr::monotonic_buffer_resource resource;
+
+    arena_storage source {&resource};
+    arena_storage target {&resource};
+
+    source.allocate(32, alignof(void*));
+    target.allocate(16, alignof(void*));
+
+    auto* data = source.data();
+
+    BOOST_TEST(target.take_over(source));
+
+    BOOST_TEST(target.data() == data);
+    BOOST_CHECK_EQUAL(target.size(), 32);
+
+    BOOST_TEST(source.data() == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(refuse_other_resource)
+{
+    std::pmr::monotonic_buffer_resource resource_1;
+    std::pmr::monotonic_buffer_resource resource_2;
+
+    arena_storage source {&resource_1};
+    arena_storage target {&resource_2};
+
+    source.allocate(32, alignof(void*));
+
+    auto* data = source.data();
+
+    BOOST_TEST(not target.take_over(source));
+
+    BOOST_TEST(source.data() == data);
+    BOOST_TEST(target.data() == nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
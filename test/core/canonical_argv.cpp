@@ -0,0 +1,352 @@
+#define BOOST_TEST_MODULE canonical_argv
+
+#include <memory_resource>
+#include <string_view>
+#include <cstring>
+#include <utility>
+#include <vector>
+#include <span>
+
+#include <boost/test/unit_test.hpp>
+
+#include "core/canonical_argv.hpp"
+#include "core/option_map.hpp"
+#include "core/dictionary.hpp"
+#include "core/option.hpp"
+#include "core/parser.hpp"
+
+#include "error/argument_cannot_be_written.hpp"
+#include "error/option_expects_argument.hpp"
+#include "error/unrecognized_option.hpp"
+
+using namespace cli::core;
+
+namespace
+{
+    const option verbose {
+	"-v",
+	"--verbose"
+    };
+
+    const option file {
+	"-f",
+	"--file",
+	{},
+	{},
+	option::required::not_required,
+	option::arguments::has_arguments
+    };
+
+    const option level {
+	"-l",
+	{},
+	{},
+	{},
+	option::required::not_required,
+	option::arguments::has_arguments
+    };
+
+    const option jobs {
+	{},
+	"--jobs",
+	{},
+	{},
+	option::required::not_required,
+	option::arguments::has_arguments
+    };
+
+    const dictionary options {verbose, file, level, jobs};
+
+    // Parses argv into a map the way a child would; parser and map must
+    // outlive the returned map's views.
+    struct parsed final
+    {
+	explicit parsed(const canonical_argv& argv) :
+	    parser {options},
+	    map    {options}
+	{
+	    parser.parse_command_line(argv.size(),
+				      const_cast<char**>(argv.data()));
+
+	    map.add_command_line_options(parser.options());
+	}
+
+	cli::core::parser parser;
+	option_map        map;
+    };
+
+    std::vector<std::string_view> tokens(const canonical_argv& argv)
+    {
+	return {argv.begin(), argv.end()};
+    }
+
+    void check_round_trip(const option_map&                 map,
+			  std::span<const std::string_view> positional,
+			  canonical_argv::argument_style    style)
+    {
+	const canonical_argv argv {"tool", map, {}, positional, style};
+
+	parsed child {argv};
+
+	BOOST_TEST(child.map.changed_options(map).empty());
+
+	BOOST_TEST(std::equal(child.parser.positional_options().begin(),
+			      child.parser.positional_options().end(),
+			      positional.begin(),
+			      positional.end()));
+
+	const canonical_argv again {
+	    "tool",
+	    child.map,
+	    {},
+	    {
+		child.parser.positional_options().data(),
+		child.parser.positional_options().size()
+	    },
+	    style
+	};
+
+	BOOST_TEST(tokens(again) == tokens(argv));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE(serialize);
+
+BOOST_AUTO_TEST_CASE(write_canonical_forms)
+{
+    const char* argv[] = {
+	"",
+	"--jobs",
+	"4",
+	"-v",
+	"-f",
+	"a.txt",
+	"-l",
+	"9",
+	"--file=b.txt",
+	nullptr
+    };
+
+    parser parser {options};
+
+    parser.parse_command_line(std::size(argv), argv);
+
+    option_map map {options};
+
+    map.add_command_line_options(parser.options());
+
+    const std::string_view positional[] = {"input"};
+
+    const canonical_argv joined {"tool", map, {}, positional};
+
+    std::vector<std::string_view> expected {
+	"tool",
+	"--verbose",
+	"--file=a.txt",
+	"--file=b.txt",
+	"-l",
+	"9",
+	"--jobs=4",
+	"input"
+    };
+
+    BOOST_TEST(tokens(joined) == expected);
+
+    BOOST_TEST((joined.data()[joined.size()] == nullptr));
+
+    const canonical_argv separate {
+	"tool", map, {}, {}, canonical_argv::argument_style::separate
+    };
+
+    expected = {
+	"tool",
+	"--verbose",
+	"--file",
+	"a.txt",
+	"--file",
+	"b.txt",
+	"-l",
+	"9",
+	"--jobs",
+	"4"
+    };
+
+    BOOST_TEST(tokens(separate) == expected);
+
+    // Every string lives in the arena behind the pointers.
+    auto* first = reinterpret_cast<const char*>(separate.data());
+
+    for (const char* token : separate)
+    {
+	BOOST_TEST((token > first &&
+		    token < first + separate.arena_size()));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(apply_overrides)
+{
+    const char* argv[] = {
+	"",
+	"-v",
+	"-f",
+	"a.txt",
+	"--jobs",
+	"4",
+	nullptr
+    };
+
+    parser parser {options};
+
+    parser.parse_command_line(std::size(argv), argv);
+
+    option_map map {options};
+
+    map.add_command_line_options(parser.options());
+
+    const std::string_view files[]  = {"x.txt", "y.txt"};
+    const std::string_view levels[] = {"1"};
+
+    const canonical_argv::option_override overrides[] = {
+	{"--file", files},
+	{"--verbose", {}, true},
+	{"-l", levels}
+    };
+
+    const canonical_argv child {"tool", map, overrides};
+
+    std::vector<std::string_view> expected {
+	"tool",
+	"--file=x.txt",
+	"--file=y.txt",
+	"-l",
+	"1",
+	"--jobs=4"
+    };
+
+    BOOST_TEST(tokens(child) == expected);
+
+    const canonical_argv::option_override unknown[] = {{"--color", {}}};
+
+    BOOST_CHECK_THROW((canonical_argv {"tool", map, unknown}),
+		      cli::error::unrecognized_option);
+
+    const canonical_argv::option_override empty[] = {{"--file", {}}};
+
+    BOOST_CHECK_THROW((canonical_argv {"tool", map, empty}),
+		      cli::error::option_expects_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE(round_trip);
+
+BOOST_AUTO_TEST_CASE(round_trip_awkward_arguments)
+{
+    option_map map {options};
+
+    const char* argv[] = {
+	"",
+	"--jobs=-1",
+	"--jobs",
+	"a,b",
+	"--jobs",
+	"",
+	"-l",
+	"x=y",
+	"--file=--file",
+	"--verbose=on,off",
+	nullptr
+    };
+
+    parser parser {options};
+
+    parser.parse_command_line(std::size(argv), argv);
+
+    map.add_command_line_options(parser.options());
+
+    BOOST_REQUIRE_EQUAL(map["--jobs"].size(), 3);
+
+    const std::string_view positional[] = {"", "p,q", "x=y"};
+
+    check_round_trip(map, positional, canonical_argv::argument_style::joined);
+
+    check_round_trip(map, positional,
+		     canonical_argv::argument_style::separate);
+}
+
+BOOST_AUTO_TEST_CASE(reject_unwritable_arguments)
+{
+    option_map map {options};
+
+    const std::string_view option_like[] = {"-x"};
+    const std::string_view both[]        = {"--x,y"};
+
+    const canonical_argv::option_override short_only[] = {
+	{"-l", option_like}
+    };
+
+    BOOST_CHECK_THROW((canonical_argv {"tool", map, short_only}),
+		      cli::error::argument_cannot_be_written);
+
+    const canonical_argv::option_override comma[] = {{"--jobs", both}};
+
+    BOOST_CHECK_THROW((canonical_argv {"tool", map, comma}),
+		      cli::error::argument_cannot_be_written);
+
+    BOOST_CHECK_THROW((canonical_argv {"tool", map, {}, option_like}),
+		      cli::error::argument_cannot_be_written);
+}
+
+// An option expecting arguments that has none would not parse back.
+BOOST_AUTO_TEST_CASE(reject_options_missing_arguments)
+{
+    option_map map {options};
+
+    const std::string_view tokens[] = {"--file"};
+
+    map.add_command_line_options(tokens);
+
+    BOOST_CHECK_THROW((canonical_argv {"tool", map}),
+		      cli::error::option_expects_argument);
+
+    const canonical_argv::option_override remove[] = {
+	{"--file", {}, true}
+    };
+
+    BOOST_CHECK_EQUAL(canonical_argv("tool", map, remove).size(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE(ownership);
+
+BOOST_AUTO_TEST_CASE(copy_and_move)
+{
+    option_map map {options};
+
+    const std::string_view positional[] = {"a", "b"};
+
+    canonical_argv argv {"tool", map, {}, positional};
+
+    canonical_argv copy {argv};
+
+    BOOST_TEST((copy.data() != argv.data()));
+    BOOST_TEST(tokens(copy) == tokens(argv));
+    BOOST_TEST((copy[1] != argv[1]));
+
+    canonical_argv moved {std::move(argv)};
+
+    BOOST_CHECK_EQUAL(moved.size(), 3);
+    BOOST_TEST((argv.data() == nullptr));
+
+    std::pmr::monotonic_buffer_resource resource;
+
+    canonical_argv other {"", map, {}, {}, {}, &resource};
+
+    other = std::move(moved);
+
+    BOOST_TEST(tokens(other) == tokens(copy));
+    BOOST_TEST((other.get_allocator().resource() == &resource));
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,117 @@
+#define BOOST_TEST_MODULE child_argv
+
+#include <memory_resource>
+#include <cstring>
+#include <utility>
+#include <span>
+
+#include <boost/test/unit_test.hpp>
+
+#include "core/child_argv.hpp"
+#include "core/dictionary.hpp"
+#include "core/option.hpp"
+#include "core/parser.hpp"
+
+using namespace cli::core;
+
+BOOST_AUTO_TEST_SUITE(build);
+
+BOOST_AUTO_TEST_CASE(build_from_parser)
+{
+    parser parser {
+	dictionary {
+	    option {
+		"-n",
+		"--dry-run"
+	    }
+	}
+    };
+
+    parser.passes_through(true);
+
+    const char* argv[] = {
+	"wrapper",
+	"--jobs",
+	"4",
+	"-n",
+	"--color",
+	nullptr
+    };
+
+    parser.parse_command_line(std::size(argv), argv);
+
+    const child_argv child {"/usr/bin/make", parser};
+
+    BOOST_REQUIRE_EQUAL(child.size(), 4);
+
+    BOOST_CHECK_EQUAL(child[0], "/usr/bin/make");
+
+    // The strings are argv's own, not copies.
+    BOOST_TEST((child[1] == argv[1]));
+    BOOST_TEST((child[2] == argv[2]));
+    BOOST_TEST((child[3] == argv[4]));
+
+    BOOST_TEST((child.data()[4] == nullptr));
+}
+
+BOOST_AUTO_TEST_CASE(build_with_prefix)
+{
+    const char* prefix[] = {"git", "-C", "repo"};
+
+    const char* first[]  = {"log", "--oneline"};
+    const char* second[] = {"-n", "3"};
+
+    const child_argv::pass_through_type runs[] = {first, second};
+
+    const child_argv child {prefix, runs};
+
+    BOOST_REQUIRE_EQUAL(child.size(), 7);
+
+    const char* expected[] = {"git", "-C", "repo", "log", "--oneline", "-n", "3"};
+
+    for (std::size_t i = 0; i < child.size(); ++i)
+    {
+	BOOST_CHECK_EQUAL(child[i], expected[i]);
+    }
+
+    BOOST_TEST((child.data()[child.size()] == nullptr));
+
+    const child_argv empty {{}, {}};
+
+    BOOST_CHECK_EQUAL(empty.size(), 0);
+    BOOST_TEST((empty.data()[0] == nullptr));
+}
+
+BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE(ownership);
+
+BOOST_AUTO_TEST_CASE(copy_and_move)
+{
+    const char* prefix[] = {"env", "-i"};
+
+    child_argv child {prefix, {}};
+
+    child_argv copy {child};
+
+    BOOST_TEST((copy.data() != child.data()));
+    BOOST_CHECK_EQUAL(copy.size(), 2);
+    BOOST_CHECK_EQUAL(copy[1], "-i");
+
+    child_argv moved {std::move(child)};
+
+    BOOST_CHECK_EQUAL(moved.size(), 2);
+    BOOST_TEST((child.data() == nullptr));
+
+    std::pmr::monotonic_buffer_resource resource;
+
+    child_argv other {{}, {}, &resource};
+
+    other = std::move(moved);
+
+    BOOST_CHECK_EQUAL(other.size(), 2);
+    BOOST_CHECK_EQUAL(other[0], "env");
+    BOOST_TEST((other.get_allocator().resource() == &resource));
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,269 @@
+#define BOOST_TEST_MODULE command_tree
+
+#include <cstddef>
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include "core/command_tree.hpp"
+#include "core/dictionary.hpp"
+#include "core/option.hpp"
+#include "core/parser.hpp"
+
+#include "error/unrecognized_subcommand.hpp"
+#include "error/unrecognized_option.hpp"
+
+using namespace cli::core;
+
+namespace
+{
+    void register_remote_add(parser& parser)
+    {
+	parser.add_dictionary(
+	    dictionary {
+		option {
+		    "-f",
+		    "--fetch"
+		}
+	    });
+    }
+
+    void register_remote(parser& parser)
+    {
+	parser.add_dictionary(
+	    dictionary {
+		option {
+		    "-v",
+		    "--verbose"
+		}
+	    });
+    }
+}
+
+BOOST_AUTO_TEST_SUITE(constructor);
+
+BOOST_AUTO_TEST_CASE(default_constructor)
+{
+    BOOST_TEST(command_tree().empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE(add_command);
+
+BOOST_AUTO_TEST_CASE(add_commands)
+{
+    command_tree commands;
+
+    auto remote     = commands.add_command({"remote"},        register_remote);
+    auto remote_add = commands.add_command({"remote", "add"}, register_remote_add);
+
+    BOOST_CHECK_EQUAL(commands.size(), 2);
+
+    BOOST_CHECK_NE(remote, remote_add);
+
+    BOOST_CHECK_EQUAL(
+	commands.add_command({"remote"}, register_remote), remote);
+
+    BOOST_CHECK_EQUAL(commands.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(own_command_names)
+{
+    command_tree commands;
+
+    std::size_t remote;
+
+    {
+	std::string name {"remote"};
+
+	remote = commands.add_command({name}, register_remote);
+
+	name.assign(name.size(), '-');
+    }
+
+    const char* argv[] = {"", "remote", nullptr};
+
+    BOOST_CHECK_EQUAL(commands.select(std::size(argv), argv).command, remote);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE(select_command);
+
+BOOST_AUTO_TEST_CASE(select_deepest_command)
+{
+    command_tree commands;
+
+    auto remote     = commands.add_command({"remote"},        register_remote);
+    auto remote_add = commands.add_command({"remote", "add"}, register_remote_add);
+
+    const char* argv_1[] = {
+	"",
+	"remote",
+	"add",
+	"origin",
+	nullptr
+    };
+
+    auto selected_1 = commands.select(std::size(argv_1), argv_1);
+
+    BOOST_CHECK_EQUAL(selected_1.command, remote_add);
+    BOOST_CHECK_EQUAL(selected_1.depth,   2);
+
+    const char* argv_2[] = {
+	"",
+	"remote",
+	"-v",
+	nullptr
+    };
+
+    auto selected_2 = commands.select(std::size(argv_2), argv_2);
+
+    BOOST_CHECK_EQUAL(selected_2.command, remote);
+    BOOST_CHECK_EQUAL(selected_2.depth,   1);
+}
+
+BOOST_AUTO_TEST_CASE(select_unregistered_command)
+{
+    command_tree commands;
+
+    commands.add_command({"remote", "add"}, register_remote_add);
+
+    const char* argv[] = {
+	"",
+	"remote",
+	nullptr
+    };
+
+    BOOST_CHECK_EQUAL(
+	commands.select(std::size(argv), argv).command, command_tree::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE(dispatch_command);
+
+BOOST_AUTO_TEST_CASE(dispatch_registered_command)
+{
+    command_tree commands;
+
+    commands.add_command({"remote"},        register_remote);
+    commands.add_command({"remote", "add"}, register_remote_add);
+
+    const char* argv[] = {
+	"",
+	"remote",
+	"add",
+	"-f",
+	"origin",
+	nullptr
+    };
+
+    parser parser;
+
+    BOOST_CHECK_NO_THROW(commands.dispatch(std::size(argv), argv, parser));
+
+    BOOST_TEST(parser.contains("--fetch").has_value());
+
+    BOOST_REQUIRE_EQUAL(parser.positional_options().size(), 1);
+
+    BOOST_CHECK_EQUAL(parser.positional_options()[0], "origin");
+}
+
+BOOST_AUTO_TEST_CASE(dispatch_with_subcommand_grammar_only)
+{
+    command_tree commands;
+
+    commands.add_command({"remote"},        register_remote);
+    commands.add_command({"remote", "add"}, register_remote_add);
+
+    const char* argv[] = {
+	"",
+	"remote",
+	"add",
+	"-v",
+	nullptr
+    };
+
+    parser parser;
+
+    BOOST_CHECK_THROW(commands.dispatch(std::size(argv), argv, parser),
+		      cli::error::unrecognized_option);
+}
+
+BOOST_AUTO_TEST_CASE(dispatch_with_reused_parser)
+{
+    command_tree commands;
+
+    commands.add_command({"remote"},        register_remote);
+    commands.add_command({"remote", "add"}, register_remote_add);
+
+    const char* remote[] = {
+	"",
+	"remote",
+	"-v",
+	nullptr
+    };
+
+    const char* remote_add[] = {
+	"",
+	"remote",
+	"add",
+	"-v",
+	nullptr
+    };
+
+    parser parser;
+
+    parser.abbreviations(true);
+
+    commands.dispatch(std::size(remote), remote, parser);
+
+    BOOST_CHECK_THROW(
+	commands.dispatch(std::size(remote_add), remote_add, parser),
+	cli::error::unrecognized_option);
+
+    BOOST_TEST(parser.abbreviations());
+}
+
+BOOST_AUTO_TEST_CASE(dispatch_unrecognized_subcommand)
+{
+    command_tree commands;
+
+    commands.add_command({"remote"}, register_remote);
+
+    const char* argv[] = {
+	"",
+	"push",
+	nullptr
+    };
+
+    parser parser;
+
+    BOOST_CHECK_THROW(commands.dispatch(std::size(argv), argv, parser),
+		      cli::error::unrecognized_subcommand);
+}
+
+BOOST_AUTO_TEST_CASE(dispatch_root_command)
+{
+    command_tree commands;
+
+    commands.add_command({}, register_remote);
+
+    const char* argv[] = {
+	"",
+	"-v",
+	nullptr
+    };
+
+    parser parser;
+
+    auto selected = commands.dispatch(std::size(argv), argv, parser);
+
+    BOOST_CHECK_EQUAL(selected.depth, 0);
+
+    BOOST_TEST(parser.contains("-v").has_value());
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -2,6 +2,7 @@
 
 #include <stdexcept>
 #include <utility>
+#include <vector>
 
 #include <boost/test/unit_test.hpp>
 
@@ -17,6 +18,20 @@ BOOST_AUTO_TEST_CASE(default_constructor)
     BOOST_TEST(dictionary().empty());
 }
 
+BOOST_AUTO_TEST_CASE(range_constructor)
+{
+    const std::vector<option> options {
+	option {"-h", "--help"},
+	option {"-v", "--verbose"}
+    };
+
+    const dictionary dictionary {options.cbegin(), options.cend()};
+
+    BOOST_CHECK_EQUAL(dictionary.size(), 2);
+
+    BOOST_TEST(dictionary.contains("--verbose"));
+}
+
 BOOST_AUTO_TEST_CASE(move_constructor)
 {
     dictionary dictionary_1 {
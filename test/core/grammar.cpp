@@ -0,0 +1,694 @@
+#define BOOST_TEST_MODULE grammar
+
+#include <string_view>
+#include <filesystem>
+#include <fstream>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "core/shared_dictionary.hpp"
+#include "core/dictionary.hpp"
+#include "core/grammar.hpp"
+#include "core/option.hpp"
+
+using namespace cli::core;
+
+BOOST_AUTO_TEST_SUITE(constructor);
+
+BOOST_AUTO_TEST_CASE(default_constructor)
+{
+    BOOST_TEST(grammar().empty());
+
+    BOOST_TEST(grammar::compile({})->empty());
+}
+
+BOOST_AUTO_TEST_CASE(dictionaries_constructor)
+{
+    const grammar grammar {
+	{
+	    dictionary {
+		option {"-h", "--help"}
+	    },
+
+	    dictionary {
+		option {
+		    "-f",
+		    "--file",
+		    {},
+		    {},
+		    option::required::required,
+		    option::arguments::has_arguments
+		}
+	    }
+	}
+    };
+
+    BOOST_CHECK_EQUAL(grammar.size(), 2);
+
+    BOOST_TEST(not grammar.is_required(0));
+    BOOST_TEST(not grammar.has_arguments(0));
+
+    BOOST_TEST(grammar.is_required(1));
+    BOOST_TEST(grammar.has_arguments(1));
+
+    BOOST_CHECK_EQUAL(grammar[1].long_name(), "--file");
+}
+
+BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE(find);
+
+BOOST_AUTO_TEST_CASE(find_option_names)
+{
+    const grammar grammar {
+	{
+	    dictionary {
+		option {"-h", "--help"},
+		option {{},   "--version"}
+	    },
+
+	    dictionary {
+		option {"-v", "--verbose"}
+	    }
+	}
+    };
+
+    BOOST_CHECK_EQUAL(grammar.find("-h"),        0);
+    BOOST_CHECK_EQUAL(grammar.find("--help"),    0);
+    BOOST_CHECK_EQUAL(grammar.find("--version"), 1);
+    BOOST_CHECK_EQUAL(grammar.find("-v"),        2);
+    BOOST_CHECK_EQUAL(grammar.find("--verbose"), 2);
+
+    BOOST_CHECK_EQUAL(grammar.find("-x"),      grammar::npos);
+    BOOST_CHECK_EQUAL(grammar.find("--verb"),  grammar::npos);
+    BOOST_CHECK_EQUAL(grammar.find("--helps"), grammar::npos);
+}
+
+BOOST_AUTO_TEST_CASE(find_short_option_names)
+{
+    const grammar grammar {
+	{
+	    dictionary {
+		option {"-a"},
+		option {"-\xff"}
+	    },
+
+	    dictionary {
+		option {"-a", "--all"},
+		option {"-b"}
+	    }
+	}
+    };
+
+    BOOST_CHECK_EQUAL(grammar.find("-a"),    0);
+    BOOST_CHECK_EQUAL(grammar.find("-\xff"), 1);
+    BOOST_CHECK_EQUAL(grammar.find("--all"), 2);
+    BOOST_CHECK_EQUAL(grammar.find("-b"),    3);
+
+    BOOST_CHECK_EQUAL(grammar.find("-c"), grammar::npos);
+
+    BOOST_CHECK_EQUAL(
+	grammar.find(std::string_view {"-\0", 2}), grammar::npos);
+}
+
+BOOST_AUTO_TEST_CASE(find_option_names_with_equality_validator)
+{
+    const grammar grammar {
+	{
+	    dictionary {
+		option {"-q", "--quiet"},
+
+		option {
+		    "-v",
+		    "--verbose",
+		    {},
+		    {},
+		    option::required::not_required,
+		    option::arguments::no_arguments,
+		    [](auto&& option_name)
+		    {
+			return (option_name == "-v"        ||
+				option_name == "--verbose" ||
+				option_name == "--no-verbose");
+		    }
+		},
+
+		option {{}, "--no-verbose"}
+	    }
+	}
+    };
+
+    BOOST_CHECK_EQUAL(grammar.find("--quiet"),      0);
+    BOOST_CHECK_EQUAL(grammar.find("-v"),           1);
+    BOOST_CHECK_EQUAL(grammar.find("--verbose"),    1);
+    BOOST_CHECK_EQUAL(grammar.find("--no-verbose"), 1);
+}
+
+BOOST_AUTO_TEST_CASE(find_in_large_dictionary)
+{
+    std::vector<std::string> names;
+
+    for (int i = 0; i < 4096; ++i)
+    {
+	names.emplace_back("--option-" + std::to_string(i));
+    }
+
+    std::vector<option> options;
+
+    for (auto&& name : names)
+    {
+	options.emplace_back(std::string_view {}, name);
+    }
+
+    const grammar grammar {
+	{
+	    dictionary {options.cbegin(), options.cend()}
+	}
+    };
+
+    BOOST_CHECK_EQUAL(grammar.size(), 4096);
+
+    BOOST_CHECK_EQUAL(grammar.find("--option-0"),    0);
+    BOOST_CHECK_EQUAL(grammar.find("--option-2048"), 2048);
+    BOOST_CHECK_EQUAL(grammar.find("--option-4095"), 4095);
+    BOOST_CHECK_EQUAL(grammar.find("--option-4096"), grammar::npos);
+}
+
+BOOST_AUTO_TEST_CASE(find_abbreviated_option_names)
+{
+    const grammar grammar {
+	{
+	    dictionary {
+		option {"-h", "--help"},
+		option {{},   "--version"},
+		option {{},   "--verbose"},
+		option {{},   "--verb"}
+	    }
+	}
+    };
+
+    BOOST_CHECK_EQUAL(grammar.find_abbreviated("--he"),     0);
+    BOOST_CHECK_EQUAL(grammar.find_abbreviated("--h"),      0);
+    BOOST_CHECK_EQUAL(grammar.find_abbreviated("-h"),       0);
+    BOOST_CHECK_EQUAL(grammar.find_abbreviated("--verbo"),  2);
+    BOOST_CHECK_EQUAL(grammar.find_abbreviated("--versi"),  1);
+    BOOST_CHECK_EQUAL(grammar.find_abbreviated("--verb"),   3);
+    BOOST_CHECK_EQUAL(grammar.find_abbreviated("--ver"),    grammar::ambiguous);
+    BOOST_CHECK_EQUAL(grammar.find_abbreviated("--"),       grammar::npos);
+    BOOST_CHECK_EQUAL(grammar.find_abbreviated("--helpme"), grammar::npos);
+    BOOST_CHECK_EQUAL(grammar.find_abbreviated("--x"),      grammar::npos);
+
+    BOOST_CHECK_EQUAL(grammar.find("--he"),  grammar::npos);
+    BOOST_CHECK_EQUAL(grammar.find("--ver"), grammar::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE(lookup_strategy);
+
+BOOST_AUTO_TEST_CASE(select_lookup_strategy)
+{
+    std::vector<std::string> names;
+
+    for (int i = 0; i < 2000; ++i)
+    {
+	names.emplace_back("--option-" + std::to_string(i));
+    }
+
+    std::vector<option> options;
+
+    for (auto&& name : names)
+    {
+	options.emplace_back(std::string_view {}, name);
+    }
+
+    const grammar small {
+	{
+	    dictionary {
+		option {"-h", "--help"},
+		option {"-i", "--input"},
+		option {"-o", "--output"}
+	    }
+	}
+    };
+
+    const grammar large {
+	{
+	    dictionary {options.cbegin(), options.cend()}
+	}
+    };
+
+    BOOST_TEST((small.strategy() == grammar::lookup_strategy::linear));
+    BOOST_TEST((large.strategy() == grammar::lookup_strategy::hash));
+
+    const grammar overridden {
+	{
+	    dictionary {options.cbegin(), options.cend()}
+	},
+	grammar::lookup_strategy::binary_search
+    };
+
+    BOOST_TEST((overridden.strategy() ==
+		grammar::lookup_strategy::binary_search));
+}
+
+BOOST_AUTO_TEST_CASE(strategies_agree)
+{
+    const dictionary dictionary {
+	option {"-h", "--help"},
+	option {{},   "--version"},
+	option {{},   "--verbose"},
+	option {{},   "--verb"},
+	option {{},   "--input-directory"},
+	option {{},   "--input-file"}
+    };
+
+    const std::string_view tokens[] = {
+	"--help", "--he", "--version", "--versi", "--verbose", "--verb",
+	"--ver", "--input", "--input-f", "--input-directory", "--inputs",
+	"--x", "--", "-h", "--helpme"
+    };
+
+    const grammar reference {{dictionary}, grammar::lookup_strategy::linear};
+
+    for (auto strategy : {
+	    grammar::lookup_strategy::binary_search,
+	    grammar::lookup_strategy::hash,
+	    grammar::lookup_strategy::trie
+	})
+    {
+	const grammar grammar {{dictionary}, strategy};
+
+	BOOST_TEST((grammar.strategy() == strategy));
+
+	for (auto token : tokens)
+	{
+	    BOOST_TEST_CONTEXT(token)
+	    {
+		BOOST_CHECK_EQUAL(grammar.find(token), reference.find(token));
+
+		BOOST_CHECK_EQUAL(grammar.find_abbreviated(token),
+				  reference.find_abbreviated(token));
+	    }
+	}
+    }
+
+    BOOST_CHECK_EQUAL(reference.find("--help"), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE(find_missing_required);
+
+BOOST_AUTO_TEST_CASE(find_missing_required_options)
+{
+    const grammar grammar {
+	{
+	    dictionary {
+		option {"-h", "--help"},
+		option {"-i", {}, {}, {}, option::required::required},
+		option {"-o", {}, {}, {}, option::required::required}
+	    }
+	}
+    };
+
+    std::vector<std::uint64_t> presence(1);
+
+    BOOST_CHECK_EQUAL(grammar.find_missing_required(presence), 1);
+
+    grammar::set(presence, 1);
+
+    BOOST_CHECK_EQUAL(grammar.find_missing_required(presence), 2);
+
+    grammar::set(presence, 2);
+
+    BOOST_CHECK_EQUAL(grammar.find_missing_required(presence), grammar::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE(compile);
+
+BOOST_AUTO_TEST_CASE(compile_shared_dictionaries)
+{
+    const std::vector<shared_dictionary> dictionaries {
+	dictionary {
+	    option {"-h", "--help"}
+	}
+    };
+
+    auto grammar_1 = grammar::compile(dictionaries);
+    auto grammar_2 = grammar::compile(dictionaries);
+
+    BOOST_TEST(grammar_1 == grammar_2);
+
+    BOOST_CHECK_EQUAL(grammar_1->find("--help"), 0);
+
+    auto grammar_3 =
+	grammar::compile(dictionaries, grammar::lookup_strategy::trie);
+
+    BOOST_TEST(grammar_1 != grammar_3);
+
+    BOOST_TEST((grammar_3->strategy() == grammar::lookup_strategy::trie));
+}
+
+BOOST_AUTO_TEST_CASE(fingerprint_of_flags)
+{
+    const grammar grammar_1 {
+	{
+	    dictionary {
+		option {"-f", "--file"}
+	    }
+	}
+    };
+
+    const grammar grammar_2 {
+	{
+	    dictionary {
+		option {
+		    "-f",
+		    "--file",
+		    {},
+		    {},
+		    option::required::not_required,
+		    option::arguments::has_arguments
+		}
+	    }
+	}
+    };
+
+    BOOST_CHECK_NE(grammar_1.fingerprint(), grammar_2.fingerprint());
+}
+
+BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE(grammar_file);
+
+namespace
+{
+    struct temporary_file final
+    {
+	explicit temporary_file(std::string_view name) :
+	    path {
+		(std::filesystem::temp_directory_path() / name).string()
+	    }
+	{
+	    std::filesystem::remove(path);
+	}
+
+	~temporary_file()
+	{
+	    std::filesystem::remove(path);
+	}
+
+	std::string path;
+    };
+
+    const dictionary file_dictionary {
+	option {"-h", "--help"},
+	option {{},   "--version"},
+	option {{},   "--verbose"},
+	option {{},   "--input-directory"},
+	option {{},   "--input-file"},
+
+	option {
+	    "-o",
+	    "--output",
+	    {},
+	    {},
+	    option::required::required,
+	    option::arguments::has_arguments
+	}
+    };
+
+    const std::string_view file_tokens[] = {
+	"--help", "--he", "--version", "--verb", "--input-f", "--output",
+	"--outputs", "-h", "-o", "-x", "--"
+    };
+
+    // A grammar file starts with a 32 byte header followed by the offset
+    // and size of each table, in this order.
+    enum table : std::size_t
+    {
+	short_table_table = 0,
+	names_table,
+	short_names_table,
+	long_names_table,
+	sorted_table,
+	hashed_table,
+	trie_table,
+	required_table,
+	arguments_table,
+	validated_table
+    };
+
+    std::uint64_t section_position(table table) noexcept
+    {
+	return 32 + table * 2 * sizeof(std::uint64_t);
+    }
+
+    template<typename T>
+    T read_at(const std::string& path, std::uint64_t position)
+    {
+	std::ifstream stream {path, std::ios::binary};
+
+	T value {};
+
+	stream.seekg(position);
+	stream.read(reinterpret_cast<char*>(&value), sizeof(value));
+
+	return value;
+    }
+
+    template<typename T>
+    void write_at(const std::string& path, std::uint64_t position, T value)
+    {
+	std::fstream stream {
+	    path, std::ios::binary | std::ios::in | std::ios::out
+	};
+
+	stream.seekp(position);
+	stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    // Overwrites the bytes at offset into one table of the file.
+    template<typename T>
+    void corrupt(const std::string& path,
+		 table              table,
+		 std::uint64_t      offset,
+		 T                  value)
+    {
+	write_at(path,
+		 read_at<std::uint64_t>(path, section_position(table)) + offset,
+		 value);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(save_and_map)
+{
+    temporary_file file {"cli_grammar_save_and_map"};
+
+    for (auto strategy : {
+	    grammar::lookup_strategy::linear,
+	    grammar::lookup_strategy::binary_search,
+	    grammar::lookup_strategy::hash,
+	    grammar::lookup_strategy::trie
+	})
+    {
+	std::vector<shared_dictionary> dictionaries {file_dictionary};
+
+	std::uint64_t fingerprint;
+
+	{
+	    const grammar built {dictionaries, strategy};
+
+	    BOOST_REQUIRE(built.save(file.path.c_str()));
+
+	    fingerprint = built.fingerprint();
+	}
+
+	auto loaded = grammar::load(file.path.c_str(), dictionaries, strategy);
+
+	BOOST_TEST(loaded->mapped());
+	BOOST_TEST((loaded->strategy() == strategy));
+	BOOST_TEST(loaded->fingerprint() == fingerprint);
+
+	const grammar reference {dictionaries, strategy};
+
+	for (auto token : file_tokens)
+	{
+	    BOOST_TEST_CONTEXT(token)
+	    {
+		BOOST_CHECK_EQUAL(loaded->find(token), reference.find(token));
+
+		BOOST_CHECK_EQUAL(loaded->find_abbreviated(token),
+				  reference.find_abbreviated(token));
+	    }
+	}
+
+	BOOST_TEST(loaded->is_required(5));
+	BOOST_TEST(loaded->has_arguments(5));
+	BOOST_TEST(not loaded->has_arguments(0));
+
+	// Parsers compiling the same dictionaries share the mapped grammar.
+	BOOST_TEST(grammar::compile(dictionaries, strategy) == loaded);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(fall_back_to_building)
+{
+    temporary_file file {"cli_grammar_fall_back"};
+
+    std::vector<shared_dictionary> dictionaries {file_dictionary};
+
+    auto missing = grammar::load(file.path.c_str(), dictionaries);
+
+    BOOST_TEST(not missing->mapped());
+    BOOST_CHECK_EQUAL(missing->find("--help"), 0);
+
+    missing.reset();
+
+    {
+	const grammar other {
+	    {
+		dictionary {
+		    option {"-h", "--help"}
+		}
+	    }
+	};
+
+	BOOST_REQUIRE(other.save(file.path.c_str()));
+    }
+
+    auto mismatched = grammar::load(file.path.c_str(), dictionaries);
+
+    BOOST_TEST(not mismatched->mapped());
+    BOOST_CHECK_EQUAL(mismatched->find("--output"), 5);
+
+    mismatched.reset();
+
+    {
+	std::ofstream stream {file.path, std::ios::binary | std::ios::trunc};
+
+	stream << "not a grammar";
+    }
+
+    BOOST_TEST(not grammar::load(file.path.c_str(), dictionaries)->mapped());
+
+    {
+	const grammar built {dictionaries};
+
+	BOOST_REQUIRE(built.save(file.path.c_str()));
+    }
+
+    std::filesystem::resize_file(
+	file.path, std::filesystem::file_size(file.path) - 1);
+
+    BOOST_TEST(not grammar::load(file.path.c_str(), dictionaries)->mapped());
+}
+
+// Files with a valid header but tables that would send lookups out of
+// bounds, or into an endless probe, are rejected like header mismatches.
+BOOST_AUTO_TEST_CASE(reject_corrupted_tables)
+{
+    using strategy = grammar::lookup_strategy;
+
+    temporary_file file {"cli_grammar_corrupted"};
+
+    std::vector<shared_dictionary> dictionaries {file_dictionary};
+
+    auto rejects = [&](strategy strategy, auto&& corrupt_file)
+    {
+	{
+	    const grammar built {dictionaries, strategy};
+
+	    BOOST_REQUIRE(built.save(file.path.c_str()));
+	}
+
+	BOOST_REQUIRE(
+	    grammar::load(file.path.c_str(), dictionaries, strategy)->mapped());
+
+	corrupt_file(file.path);
+
+	return not grammar::load(
+	    file.path.c_str(), dictionaries, strategy)->mapped();
+    };
+
+    // The short table entry of -h names an option that does not exist.
+    BOOST_TEST(rejects(strategy::linear, [](auto&& path)
+    {
+	corrupt(path, short_table_table, 'h' * 4, std::uint32_t {1000});
+    }));
+
+    // ... or an option with another short name.
+    BOOST_TEST(rejects(strategy::linear, [](auto&& path)
+    {
+	corrupt(path, short_names_table, 0, 'x');
+    }));
+
+    BOOST_TEST(rejects(strategy::linear, [](auto&& path)
+    {
+	corrupt(path, long_names_table, 0, std::uint32_t {0x10000});
+    }));
+
+    // Ids are the third field of sorted names.
+    BOOST_TEST(rejects(strategy::binary_search, [](auto&& path)
+    {
+	corrupt(path, sorted_table, 8, std::uint32_t {1000});
+    }));
+
+    BOOST_TEST(rejects(strategy::hash, [](auto&& path)
+    {
+	corrupt(path, hashed_table, 0, std::uint32_t {1000});
+    }));
+
+    BOOST_TEST(rejects(strategy::hash, [](auto&& path)
+    {
+	auto size = read_at<std::uint64_t>(
+	    path, section_position(hashed_table) + sizeof(std::uint64_t));
+
+	for (std::uint64_t slot = 0; slot < size; ++slot)
+	{
+	    corrupt(path, hashed_table, slot * 4, std::uint32_t {0});
+	}
+    }));
+
+    BOOST_TEST(rejects(strategy::hash, [](auto&& path)
+    {
+	write_at(path,
+		 section_position(hashed_table) + sizeof(std::uint64_t),
+		 std::uint64_t {7});
+    }));
+
+    // The root node's label offset, then its first child.
+    BOOST_TEST(rejects(strategy::trie, [](auto&& path)
+    {
+	corrupt(path, trie_table, 0, std::uint32_t {0x10000});
+    }));
+
+    BOOST_TEST(rejects(strategy::trie, [](auto&& path)
+    {
+	corrupt(path, trie_table, 8, std::uint32_t {1000});
+    }));
+
+    BOOST_TEST(rejects(strategy::trie, [](auto&& path)
+    {
+	corrupt(path, trie_table, 8, std::uint32_t {0});
+    }));
+
+    BOOST_TEST(rejects(strategy::linear, [](auto&& path)
+    {
+	corrupt(path, required_table, 0, ~std::uint64_t {0});
+    }));
+
+    BOOST_TEST(rejects(strategy::linear, [](auto&& path)
+    {
+	corrupt(path, arguments_table, 0, ~std::uint64_t {0});
+    }));
+}
+
+BOOST_AUTO_TEST_SUITE_END();
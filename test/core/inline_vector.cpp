@@ -0,0 +1,107 @@
+#define BOOST_TEST_MODULE inline_vector
+
+#include <memory_resource>
+#include <string_view>
+#include <cstddef>
+#include <utility>
+#include <array>
+
+#include <boost/test/unit_test.hpp>
+
+#include "core/inline_vector.hpp"
+
+using namespace cli::core;
+
+BOOST_AUTO_TEST_SUITE(storage);
+
+BOOST_AUTO_TEST_CASE(keep_elements_inline)
+{
+    inline_vector<std::string_view, 2> vector;
+
+    vector.emplace_back("a");
+    vector.emplace_back("b");
+
+    BOOST_TEST(vector.is_inline());
+
+    BOOST_CHECK_EQUAL(vector.size(), 2);
+    BOOST_CHECK_EQUAL(vector.back(), "b");
+
+    vector.emplace_back("c");
+
+    BOOST_TEST(not vector.is_inline());
+
+    BOOST_CHECK_EQUAL(vector.size(),     3);
+    BOOST_CHECK_EQUAL(vector.capacity(), 4);
+    BOOST_CHECK_EQUAL(vector[0], "a");
+    BOOST_CHECK_EQUAL(vector[2], "c");
+
+    vector.clear();
+
+    BOOST_TEST(vector.empty());
+    BOOST_CHECK_EQUAL(vector.capacity(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(copy_and_move)
+{
+    inline_vector<int, 2> small;
+
+    small.emplace_back(1);
+
+    inline_vector<int, 2> large;
+
+    for (int i = 0; i < 5; ++i)
+    {
+	large.emplace_back(i);
+    }
+
+    auto moved_small = std::move(small);
+    auto moved_large = std::move(large);
+
+    BOOST_TEST(moved_small.is_inline());
+    BOOST_TEST(not moved_large.is_inline());
+
+    BOOST_TEST(small.empty());
+    BOOST_TEST(large.empty());
+
+    BOOST_CHECK_EQUAL(moved_small[0], 1);
+    BOOST_CHECK_EQUAL(moved_large[4], 4);
+
+    inline_vector<int, 2> copy {moved_large};
+
+    BOOST_CHECK_EQUAL(copy.size(), 5);
+    BOOST_CHECK_EQUAL(copy[3], 3);
+
+    copy = moved_small;
+
+    BOOST_CHECK_EQUAL(copy.size(), 1);
+    BOOST_CHECK_EQUAL(copy[0], 1);
+
+    moved_small = std::move(copy);
+
+    BOOST_CHECK_EQUAL(moved_small.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(spill_into_memory_resource)
+{
+    std::array<std::byte, 256> buffer;
+
+    std::pmr::monotonic_buffer_resource arena {
+	buffer.data(), buffer.size(), std::pmr::null_memory_resource()
+    };
+
+    inline_vector<int, 1, std::pmr::polymorphic_allocator<int>> vector {
+	&arena
+    };
+
+    for (int i = 0; i < 8; ++i)
+    {
+	vector.emplace_back(i);
+    }
+
+    BOOST_TEST(vector.get_allocator().resource() == &arena);
+
+    BOOST_CHECK_EQUAL(vector.size(), 8);
+    BOOST_CHECK_EQUAL(vector[7], 7);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
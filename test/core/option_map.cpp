@@ -1,6 +1,9 @@
 #define BOOST_TEST_MODULE option_map
 
+#include <string_view>
+#include <algorithm>
 #include <utility>
+#include <span>
 
 #include <boost/test/unit_test.hpp>
 
@@ -11,6 +14,7 @@
 
 #include "error/accessing_option_without_arguments.hpp"
 #include "error/accessing_option_not_yet_added.hpp"
+#include "error/argument_without_option.hpp"
 #include "error/unrecognized_option.hpp"
 
 using namespace cli::core;
@@ -146,6 +150,132 @@ BOOST_AUTO_TEST_CASE(add_mixed_command_line_options)
     BOOST_CHECK_EQUAL(map.contains("--no-verbose").value(), "--no-verbose");
 }
 
+BOOST_AUTO_TEST_CASE(add_abbreviated_command_line_options)
+{
+    const dictionary dictionary {
+	option {"-h", "--help"},
+
+	option {
+	    "-f",
+	    "--file",
+	    {},
+	    {},
+	    option::required::not_required,
+	    option::arguments::has_arguments
+	}
+    };
+
+    const char* argv[] = {
+	"",
+	"--fi=a.txt,b.txt",
+	"--h",
+	"--file",
+	"c.txt",
+	nullptr
+    };
+
+    parser parser {dictionary};
+
+    parser.abbreviations(true);
+
+    parser.parse_command_line(std::size(argv), argv);
+
+    option_map map {dictionary};
+
+    map.add_command_line_options(parser.options());
+
+    BOOST_TEST(map.contains("--help").has_value());
+
+    BOOST_REQUIRE_EQUAL(map["--file"].size(), 3);
+
+    BOOST_CHECK_EQUAL(map["-f"][0], "a.txt");
+    BOOST_CHECK_EQUAL(map["-f"][1], "b.txt");
+    BOOST_CHECK_EQUAL(map["-f"][2], "c.txt");
+}
+
+BOOST_AUTO_TEST_CASE(key_options_by_canonical_name)
+{
+    const dictionary dictionary {
+	option {"-h", "--help"},
+	option {"-q"},
+
+	option {
+	    "-f",
+	    "--file",
+	    {},
+	    {},
+	    option::required::not_required,
+	    option::arguments::has_arguments
+	}
+    };
+
+    const option_map::key_type options[] = {
+	"--fi=a.txt",
+	"-q",
+	"--he",
+	"--unknown=b.txt",
+	"--other",
+	"c.txt",
+	"--unknown=d.txt"
+    };
+
+    option_map map {dictionary};
+
+    map.add_command_line_options(options);
+
+    BOOST_CHECK_EQUAL(map.contains("-f").value(),      "--file");
+    BOOST_CHECK_EQUAL(map.contains("--help").value(),  "--help");
+    BOOST_CHECK_EQUAL(map.contains("-q").value(),      "-q");
+
+    BOOST_TEST(map.contains(dictionary["--help"]));
+    BOOST_TEST(map.contains(dictionary["--file"]));
+
+    BOOST_REQUIRE_EQUAL(map["--file"].size(), 1);
+    BOOST_CHECK_EQUAL(map["--file"][0], "a.txt");
+
+    // Unknown options keep an entry per name with their own arguments.
+    auto changed = map.changed_options(option_map {dictionary});
+
+    BOOST_CHECK_EQUAL(std::count(changed.cbegin(),
+				 changed.cend(),
+				 grammar::npos),
+		      2);
+}
+
+BOOST_AUTO_TEST_CASE(reject_leading_argument)
+{
+    const dictionary dictionary {
+	option {
+	    "-f",
+	    "--file",
+	    {},
+	    {},
+	    option::required::not_required,
+	    option::arguments::has_arguments
+	}
+    };
+
+    const option_map::key_type options[] = {"a.txt", "-f", "b.txt"};
+
+    option_map map {dictionary};
+
+    BOOST_CHECK_THROW(map.add_command_line_options(options),
+		      cli::error::argument_without_option);
+
+    BOOST_TEST(not map.contains("-f"));
+
+    map.add_command_line_options(std::span {options}.subspan(1));
+
+    BOOST_REQUIRE_EQUAL(map["-f"].size(), 1);
+    BOOST_CHECK_EQUAL(map["-f"][0], "b.txt");
+
+    // The first entry of a filled map does not take it either.
+    BOOST_CHECK_THROW(map.add_command_line_options(options),
+		      cli::error::argument_without_option);
+
+    BOOST_CHECK_EQUAL(map["-f"].size(), 1);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
 
 BOOST_AUTO_TEST_SUITE(add_dictionary);
@@ -556,3 +686,49 @@ BOOST_AUTO_TEST_CASE(access_to_unrecognized_option)
 }
 
 BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE(changed_options);
+
+BOOST_AUTO_TEST_CASE(compare_maps)
+{
+    const dictionary dictionary {
+	option {"-a", "--all"},
+	option {"-b", "--brief"},
+
+	option {
+	    "-c",
+	    "--color",
+	    {},
+	    {},
+	    option::required::not_required,
+	    option::arguments::has_arguments
+	},
+
+	option {
+	    "-d",
+	    "--depth",
+	    {},
+	    {},
+	    option::required::not_required,
+	    option::arguments::has_arguments
+	}
+    };
+
+    option_map before {dictionary};
+    option_map after  {dictionary};
+
+    const std::string_view old_options[] = {"-a", "-c", "red", "-d", "1"};
+    const std::string_view new_options[] = {"--depth=1", "-b", "-c", "blue"};
+
+    before.add_command_line_options(old_options);
+    after.add_command_line_options(new_options);
+
+    auto changed = after.changed_options(before);
+
+    BOOST_REQUIRE_EQUAL(changed.size(), 3);
+    BOOST_TEST(changed == before.changed_options(after));
+
+    BOOST_TEST(before.changed_options(before).empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END();
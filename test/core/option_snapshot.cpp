@@ -0,0 +1,200 @@
+#define BOOST_TEST_MODULE option_snapshot
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "core/option_snapshot.hpp"
+#include "core/option_map.hpp"
+#include "core/dictionary.hpp"
+#include "core/option.hpp"
+#include "core/parser.hpp"
+
+#include "error/accessing_option_without_arguments.hpp"
+#include "error/accessing_option_not_yet_added.hpp"
+#include "error/unrecognized_option.hpp"
+#include "error/invalid_snapshot.hpp"
+
+using namespace cli::core;
+
+namespace
+{
+    const option file {
+	"-f",
+	"--file",
+	"-f, --file",
+	{},
+	option::required::not_required,
+	option::arguments::has_arguments
+    };
+
+    const dictionary snapshot_dictionary {
+	file,
+
+	option {
+	    "-i",
+	    "--include",
+	    "-i, --include",
+	    {},
+	    option::required::not_required,
+	    option::arguments::has_arguments
+	},
+
+	option {"-v", "--verbose", "-v, --verbose"},
+	option {"-q", "--quiet",   "-q, --quiet"}
+    };
+
+    std::vector<std::byte> write_snapshot(int argc, const char** argv)
+    {
+	parser parser {snapshot_dictionary};
+
+	parser.parse_command_line(argc, argv);
+
+	option_map map {snapshot_dictionary};
+
+	map.add_command_line_options(parser.options());
+
+	return option_snapshot::write(map);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE(round_trip);
+
+BOOST_AUTO_TEST_CASE(read_written_options)
+{
+    const char* argv[] = {
+	"worker", "-v", "--include=a,b", "--file=c", "-i", "d"
+    };
+
+    auto blob = write_snapshot(6, argv);
+
+    const option_snapshot snapshot {blob, {snapshot_dictionary}};
+
+    BOOST_TEST(snapshot.size() == 3);
+
+    // Options are kept under their canonical name, whatever was typed.
+    BOOST_TEST(snapshot.contains("-v").value() == "--verbose");
+    BOOST_TEST(not snapshot.contains("-q").has_value());
+    BOOST_TEST(snapshot.contains(file));
+
+    auto include = snapshot["--include"];
+
+    BOOST_REQUIRE_EQUAL(include.size(), 3);
+    BOOST_TEST(include[0] == "a");
+    BOOST_TEST(include[1] == "b");
+    BOOST_TEST(include.back() == "d");
+
+    std::vector<std::string_view> arguments (
+	snapshot[file].begin(), snapshot[file].end());
+
+    BOOST_REQUIRE_EQUAL(arguments.size(), 1);
+    BOOST_TEST(arguments[0] == "c");
+}
+
+BOOST_AUTO_TEST_CASE(relocate_blob)
+{
+    const char* argv[] = {"worker", "-f", "x"};
+
+    auto blob = write_snapshot(3, argv);
+
+    std::vector<std::byte> moved (blob.size() + 3);
+
+    std::memcpy(moved.data() + 3, blob.data(), blob.size());
+
+    blob.assign(blob.size(), std::byte {0});
+
+    const option_snapshot snapshot {
+	std::span {moved}.subspan(3),
+	option_map {snapshot_dictionary}
+    };
+
+    BOOST_TEST(snapshot["--file"].front() == "x");
+}
+
+BOOST_AUTO_TEST_CASE(empty_command_line)
+{
+    const char* argv[] = {"worker"};
+
+    auto blob = write_snapshot(1, argv);
+
+    const option_snapshot snapshot {blob, {snapshot_dictionary}};
+
+    BOOST_TEST(snapshot.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE(access_errors);
+
+BOOST_AUTO_TEST_CASE(raise_like_option_map)
+{
+    const char* argv[] = {"worker", "-v"};
+
+    auto blob = write_snapshot(2, argv);
+
+    const option_snapshot snapshot {blob, {snapshot_dictionary}};
+
+    BOOST_CHECK_THROW(snapshot["-v"],
+		      cli::error::accessing_option_without_arguments);
+
+    BOOST_CHECK_THROW(snapshot["-f"],
+		      cli::error::accessing_option_not_yet_added);
+
+    BOOST_CHECK_THROW(snapshot["-x"], cli::error::unrecognized_option);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE(validation);
+
+BOOST_AUTO_TEST_CASE(detect_grammar_mismatch)
+{
+    const char* argv[] = {"worker", "-v"};
+
+    auto blob = write_snapshot(2, argv);
+
+    const dictionary other {option {"-v", "--verbose", "-v, --verbose"}};
+
+    BOOST_CHECK_THROW((option_snapshot {blob, {other}}),
+		      cli::error::invalid_snapshot);
+}
+
+BOOST_AUTO_TEST_CASE(detect_damaged_blob)
+{
+    const char* argv[] = {"worker", "-f", "x", "-v"};
+
+    auto blob = write_snapshot(4, argv);
+
+    BOOST_CHECK_THROW(
+	(option_snapshot {std::span {blob}.first(16), {snapshot_dictionary}}),
+	cli::error::invalid_snapshot);
+
+    BOOST_CHECK_THROW(
+	(option_snapshot {
+	    std::span {blob}.first(blob.size() - 1),
+	    {snapshot_dictionary}
+	}),
+	cli::error::invalid_snapshot);
+
+    auto corrupt = blob;
+
+    corrupt[0] = std::byte {0};
+
+    BOOST_CHECK_THROW((option_snapshot {corrupt, {snapshot_dictionary}}),
+		      cli::error::invalid_snapshot);
+
+    // The key offset of the first entry.
+    corrupt = blob;
+
+    std::uint32_t offset = 0xffff;
+
+    std::memcpy(corrupt.data() + 32 + 8 + 4 + 4, &offset, sizeof(offset));
+
+    BOOST_CHECK_THROW((option_snapshot {corrupt, {snapshot_dictionary}}),
+		      cli::error::invalid_snapshot);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,150 @@
+#define BOOST_TEST_MODULE owned_command_line
+
+#include <memory_resource>
+#include <string_view>
+#include <utility>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "core/owned_command_line.hpp"
+#include "core/option_map.hpp"
+#include "core/dictionary.hpp"
+#include "core/option.hpp"
+#include "core/parser.hpp"
+
+using namespace cli::core;
+
+namespace
+{
+    const dictionary owned_dictionary {
+	option {
+	    "-f",
+	    "--file",
+	    "-f, --file",
+	    {},
+	    option::required::not_required,
+	    option::arguments::has_arguments
+	},
+
+	option {"-v", "--verbose", "-v, --verbose"}
+    };
+
+    // Parses a command line that is overwritten before the result is used.
+    owned_command_line
+    parse_and_free(const owned_command_line::allocator_type& allocator = {})
+    {
+	std::vector<std::string> tokens {
+	    "program", "--file=a.txt", "-v", "input", "-f", "b.txt"
+	};
+
+	std::vector<const char*> argv;
+
+	for (auto&& token : tokens)
+	{
+	    argv.emplace_back(token.c_str());
+	}
+
+	parser parser {owned_dictionary};
+
+	parser.parse_command_line(argv.size(), argv.data());
+
+	owned_command_line owned {parser, allocator};
+
+	for (auto&& token : tokens)
+	{
+	    token.assign(token.size(), '#');
+	}
+
+	return owned;
+    }
+
+    void check(const owned_command_line& owned)
+    {
+	BOOST_REQUIRE_EQUAL(owned.options().size(), 4);
+	BOOST_TEST(owned.options()[0] == "--file=a.txt");
+	BOOST_TEST(owned.options()[1] == "-v");
+	BOOST_TEST(owned.options()[3] == "b.txt");
+
+	BOOST_REQUIRE_EQUAL(owned.positional_options().size(), 1);
+	BOOST_TEST(owned.positional_options()[0] == "input");
+    }
+}
+
+BOOST_AUTO_TEST_SUITE(ownership);
+
+BOOST_AUTO_TEST_CASE(outlive_command_line)
+{
+    auto owned = parse_and_free();
+
+    check(owned);
+
+    BOOST_TEST(owned.arena_size() ==
+	       5 * sizeof(std::string_view) + 12 + 2 + 5 + 2 + 5);
+}
+
+BOOST_AUTO_TEST_CASE(copy_and_move)
+{
+    auto owned = parse_and_free();
+
+    owned_command_line copy {owned};
+
+    check(copy);
+
+    const void* data = owned.options()[0].data();
+
+    BOOST_TEST(static_cast<const void*>(copy.options()[0].data()) != data);
+
+    owned_command_line moved {std::move(owned)};
+
+    check(moved);
+
+    BOOST_TEST(static_cast<const void*>(moved.options()[0].data()) == data);
+    BOOST_TEST(owned.options().empty());
+
+    owned = std::move(moved);
+
+    check(owned);
+
+    copy = owned_command_line {};
+
+    BOOST_TEST(copy.options().empty());
+    BOOST_TEST(copy.arena_size() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(fill_option_map)
+{
+    option_map map {owned_dictionary};
+
+    auto owned = parse_and_free();
+
+    map.add_command_line_options(owned.options());
+
+    BOOST_REQUIRE_EQUAL(map["--file"].size(), 2);
+    BOOST_TEST(map["--file"][0] == "a.txt");
+    BOOST_TEST(map["--file"][1] == "b.txt");
+}
+
+BOOST_AUTO_TEST_CASE(use_memory_resource)
+{
+    std::pmr::monotonic_buffer_resource arena;
+
+    auto owned = parse_and_free(&arena);
+
+    BOOST_TEST(owned.get_allocator().resource() == &arena);
+
+    check(owned);
+
+    std::pmr::monotonic_buffer_resource other;
+
+    owned_command_line target {&other};
+
+    target = std::move(owned);
+
+    check(target);
+
+    BOOST_TEST(target.get_allocator().resource() == &other);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
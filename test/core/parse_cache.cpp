@@ -0,0 +1,175 @@
+#define BOOST_TEST_MODULE parse_cache
+
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include "core/parse_cache.hpp"
+#include "core/dictionary.hpp"
+#include "core/option.hpp"
+
+#include "error/unrecognized_option.hpp"
+
+using namespace cli::core;
+
+namespace
+{
+    const dictionary cache_dictionary {
+	option {
+	    "-f",
+	    "--file",
+	    "-f, --file",
+	    {},
+	    option::required::not_required,
+	    option::arguments::has_arguments
+	},
+
+	option {"-v", "--verbose", "-v, --verbose"}
+    };
+}
+
+BOOST_AUTO_TEST_SUITE(lookup);
+
+BOOST_AUTO_TEST_CASE(miss_then_hit)
+{
+    parse_cache cache {{cache_dictionary}, 4};
+
+    const char* argv[] = {"job", "--file", "a.txt", "-v", "input"};
+
+    auto first  = cache.parse(5, argv);
+    auto second = cache.parse(5, argv);
+
+    BOOST_TEST(first == second);
+
+    BOOST_TEST(first->options()["--file"].front() == "a.txt");
+    BOOST_TEST(first->options().contains("-v").has_value());
+
+    BOOST_REQUIRE_EQUAL(first->positional_options().size(), 1);
+    BOOST_TEST(first->positional_options()[0] == "input");
+
+    BOOST_TEST(cache.stats().hits   == 1);
+    BOOST_TEST(cache.stats().misses == 1);
+    BOOST_TEST(cache.stats().hit_rate() == 0.5);
+}
+
+// Like the parser, the cache reads argv up to the first null entry.
+BOOST_AUTO_TEST_CASE(stop_at_null_entry)
+{
+    parse_cache cache {{cache_dictionary}, 4};
+
+    const char* argv[] = {"job", "-v", "input", nullptr, "ignored"};
+
+    auto first  = cache.parse(5, argv);
+    auto second = cache.parse(3, argv);
+
+    BOOST_TEST(first == second);
+
+    BOOST_REQUIRE_EQUAL(first->positional_options().size(), 1);
+    BOOST_TEST(first->positional_options()[0] == "input");
+
+    BOOST_TEST(parse_result::hash(5, argv) == parse_result::hash(3, argv));
+    BOOST_TEST(first->matches(4, argv));
+}
+
+BOOST_AUTO_TEST_CASE(result_owns_tokens)
+{
+    parse_cache cache {{cache_dictionary}, 4};
+
+    std::string file = "a.txt";
+
+    const char* argv[] = {"job", "--file", file.c_str()};
+
+    auto result = cache.parse(3, argv);
+
+    file = "b.txt";
+
+    BOOST_TEST(result->options()["--file"].front() == "a.txt");
+    BOOST_TEST(not result->matches(3, argv));
+}
+
+BOOST_AUTO_TEST_CASE(match_token_boundaries)
+{
+    parse_cache cache {{cache_dictionary}, 4};
+
+    const char* joined[]  = {"job", "-v", "ab"};
+    const char* split[]   = {"job", "-v", "a", "b"};
+    const char* shifted[] = {"job", "-va", "b"};
+
+    auto result = cache.parse(3, joined);
+
+    BOOST_TEST(result->matches(3, joined));
+    BOOST_TEST(not result->matches(4, split));
+    BOOST_TEST(not result->matches(3, shifted));
+}
+
+BOOST_AUTO_TEST_CASE(errors_not_cached)
+{
+    parse_cache cache {{cache_dictionary}, 4};
+
+    const char* argv[] = {"job", "--unknown"};
+
+    BOOST_CHECK_THROW(cache.parse(2, argv), cli::error::unrecognized_option);
+    BOOST_CHECK_THROW(cache.parse(2, argv), cli::error::unrecognized_option);
+
+    BOOST_TEST(cache.size() == 0);
+    BOOST_TEST(cache.stats().misses == 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE(eviction);
+
+BOOST_AUTO_TEST_CASE(evict_least_recently_used)
+{
+    parse_cache cache {{cache_dictionary}, 2};
+
+    const char* a[] = {"job", "a"};
+    const char* b[] = {"job", "b"};
+    const char* c[] = {"job", "c"};
+
+    auto first = cache.parse(2, a);
+
+    cache.parse(2, b);
+    cache.parse(2, a);
+    cache.parse(2, c);
+
+    BOOST_TEST(cache.size() == 2);
+    BOOST_TEST(cache.stats().evictions == 1);
+
+    BOOST_TEST(cache.parse(2, a) == first);
+    BOOST_TEST(cache.stats().hits == 2);
+
+    cache.parse(2, b);
+
+    BOOST_TEST(cache.stats().misses == 4);
+}
+
+BOOST_AUTO_TEST_CASE(zero_capacity)
+{
+    parse_cache cache {{cache_dictionary}, 0};
+
+    const char* argv[] = {"job", "-v"};
+
+    BOOST_TEST(cache.parse(2, argv)->options().contains("-v").has_value());
+    BOOST_TEST(cache.parse(2, argv)->options().contains("-v").has_value());
+
+    BOOST_TEST(cache.size() == 0);
+    BOOST_TEST(cache.stats().misses == 2);
+}
+
+BOOST_AUTO_TEST_CASE(clear_entries)
+{
+    parse_cache cache {{cache_dictionary}, 2};
+
+    const char* argv[] = {"job", "-v"};
+
+    auto result = cache.parse(2, argv);
+
+    cache.clear();
+
+    BOOST_TEST(cache.size() == 0);
+    BOOST_TEST(result->options().contains("-v").has_value());
+    BOOST_TEST(cache.parse(2, argv) != result);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,181 @@
+#define BOOST_TEST_MODULE parse_stats
+
+#include <type_traits>
+#include <chrono>
+
+#include <boost/test/unit_test.hpp>
+
+#include "configuration/instrumentation.hpp"
+
+#include "core/parse_stats.hpp"
+#include "core/dictionary.hpp"
+#include "core/option_map.hpp"
+#include "core/option.hpp"
+#include "core/parser.hpp"
+
+using namespace cli::core;
+
+namespace
+{
+    const dictionary interfaces {
+	option {"-h", "--help"},
+
+	option {
+	    "-i",
+	    "--interface",
+	    {},
+	    {},
+	    option::required::required,
+	    option::arguments::has_arguments
+	},
+
+	option {
+	    "-v",
+	    "--verbose",
+	    {},
+	    {},
+	    option::required::not_required,
+	    option::arguments::no_arguments,
+	    [](auto&& option_name)
+	    {
+		return (option_name == "-v" ||
+			option_name == "--verbose" ||
+			option_name == "--no-verbose");
+	    }
+	}
+    };
+
+    const char* argv[] = {
+	"",
+	"-h",
+	"--interface=wlan0,ppp0",
+	"data.dat",
+	"--no-verbose",
+	"-i",
+	"eth0",
+	nullptr
+    };
+}
+
+BOOST_AUTO_TEST_SUITE(accumulate);
+
+BOOST_AUTO_TEST_CASE(add_stats)
+{
+    parse_stats stats;
+
+    stats.tokens  = 2;
+    stats.resolve = std::chrono::nanoseconds {5};
+
+    parse_stats other;
+
+    other.tokens                = 3;
+    other.estimated_allocations = 1;
+    other.resolve               = std::chrono::nanoseconds {7};
+
+    stats += other;
+
+    BOOST_CHECK_EQUAL(stats.tokens,                5);
+    BOOST_CHECK_EQUAL(stats.estimated_allocations, 1);
+    BOOST_CHECK_EQUAL(stats.resolve.count(), 12);
+}
+
+BOOST_AUTO_TEST_CASE(keep_nothing_without_instrumentation)
+{
+    constexpr bool compiled_out = not INSTRUMENTATION_ENABLED;
+
+    BOOST_CHECK_EQUAL(std::is_empty_v<stats_storage>,      compiled_out);
+    BOOST_CHECK_EQUAL(std::is_empty_v<stats_hook_storage>, compiled_out);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE(parser_stats);
+
+BOOST_AUTO_TEST_CASE(collect_parse_stats)
+{
+    parser parser {interfaces};
+
+    int published = 0;
+
+    parser.stats_hook([&](const parse_stats& stats)
+    {
+	++published;
+
+	BOOST_CHECK_EQUAL(stats.tokens, 6);
+    });
+
+    parser.parse_command_line(std::size(argv), argv);
+
+    auto& stats = parser.stats();
+
+#if INSTRUMENTATION_ENABLED
+
+    BOOST_CHECK_EQUAL(published, 1);
+
+    BOOST_CHECK_EQUAL(stats.tokens,          6);
+    BOOST_CHECK_EQUAL(stats.lookups,         4);
+    BOOST_CHECK_EQUAL(stats.validator_calls, 1);
+
+    BOOST_TEST(stats.comparisons >= stats.validator_calls);
+
+    // Allocations are only estimated, so no exact bound is checked.
+    BOOST_TEST(stats.estimated_allocations > 0);
+
+    BOOST_TEST(stats.resolve.count() > 0);
+
+#else
+
+    BOOST_CHECK_EQUAL(published, 0);
+
+    BOOST_CHECK_EQUAL(stats.tokens, 0);
+    BOOST_CHECK_EQUAL(stats.lookups, 0);
+
+#endif
+
+    parser.parse_command_line(std::size(argv), argv);
+
+    BOOST_CHECK_EQUAL(parser.stats().tokens, stats.tokens);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE(option_map_stats);
+
+BOOST_AUTO_TEST_CASE(collect_map_build_stats)
+{
+    parser parser {interfaces};
+
+    parser.parse_command_line(std::size(argv), argv);
+
+    option_map map {interfaces};
+
+    int published = 0;
+
+    map.stats_hook([&](const parse_stats&)
+    {
+	++published;
+    });
+
+    map.add_command_line_options(parser.options());
+
+    auto& stats = map.stats();
+
+#if INSTRUMENTATION_ENABLED
+
+    BOOST_CHECK_EQUAL(published, 1);
+
+    BOOST_CHECK_EQUAL(stats.tokens,  parser.options().size());
+    BOOST_CHECK_EQUAL(stats.lookups, 4);
+
+    BOOST_TEST(stats.estimated_allocations > 0);
+
+#else
+
+    BOOST_CHECK_EQUAL(published, 0);
+
+    BOOST_CHECK_EQUAL(stats.tokens, 0);
+
+#endif
+}
+
+BOOST_AUTO_TEST_SUITE_END();
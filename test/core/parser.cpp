@@ -1,9 +1,15 @@
 #define BOOST_TEST_MODULE parser
 
+#include <string_view>
 #include <utility>
+#include <string>
+#include <vector>
+#include <ranges>
 
 #include <boost/test/unit_test.hpp>
 
+#include "core/parse_event.hpp"
+#include "core/diagnostic.hpp"
 #include "core/dictionary.hpp"
 #include "core/option.hpp"
 #include "core/parser.hpp"
@@ -12,6 +18,7 @@
 #include "error/option_already_added_as.hpp"
 #include "error/option_expects_argument.hpp"
 #include "error/unrecognized_option.hpp"
+#include "error/ambiguous_option.hpp"
 
 using namespace cli::core;
 
@@ -630,3 +637,728 @@ BOOST_AUTO_TEST_CASE(parse_missing_required_option)
 }
 
 BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE(abbreviations);
+
+const dictionary abbreviated_dictionary {
+    option {"-h", "--help"},
+    option {{},   "--verbose"},
+    option {{},   "--version"},
+
+    option {
+	"-f",
+	"--file",
+	{},
+	{},
+	option::required::not_required,
+	option::arguments::has_arguments
+    }
+};
+
+BOOST_AUTO_TEST_CASE(abbreviations_disabled_by_default)
+{
+    parser parser {abbreviated_dictionary};
+
+    BOOST_TEST(not parser.abbreviations());
+
+    const char* argv[] = {
+	"",
+	"--verb",
+	nullptr
+    };
+
+    BOOST_CHECK_THROW(parser.parse_command_line(std::size(argv), argv),
+		      cli::error::unrecognized_option);
+}
+
+BOOST_AUTO_TEST_CASE(parse_unique_prefixes)
+{
+    parser parser {abbreviated_dictionary};
+
+    parser.abbreviations(true);
+
+    const char* argv[] = {
+	"",
+	"--verb",
+	"--he",
+	"--fi=a.txt",
+	"--f",
+	"b.txt",
+	nullptr
+    };
+
+    parser.parse_command_line(std::size(argv), argv);
+
+    BOOST_TEST(parser.contains("--verbose").has_value());
+    BOOST_TEST(parser.contains("--help").has_value());
+    BOOST_TEST(parser.contains("--file").has_value());
+
+    BOOST_CHECK_EQUAL(parser.contains("--verbose").value(), "--verb");
+
+    BOOST_REQUIRE_EQUAL(parser.options().size(), 5);
+
+    BOOST_CHECK_EQUAL(parser.options()[2], "--fi=a.txt");
+    BOOST_CHECK_EQUAL(parser.options()[4], "b.txt");
+}
+
+BOOST_AUTO_TEST_CASE(parse_ambiguous_prefix)
+{
+    parser parser {abbreviated_dictionary};
+
+    parser.abbreviations(true);
+
+    const char* argv[] = {
+	"",
+	"--ver",
+	nullptr
+    };
+
+    BOOST_CHECK_THROW(parser.parse_command_line(std::size(argv), argv),
+		      cli::error::ambiguous_option);
+}
+
+BOOST_AUTO_TEST_CASE(parse_already_added_abbreviation)
+{
+    parser parser {abbreviated_dictionary};
+
+    parser.abbreviations(true);
+
+    const char* argv[] = {
+	"",
+	"--he",
+	"-h",
+	nullptr
+    };
+
+    BOOST_CHECK_THROW(parser.parse_command_line(std::size(argv), argv),
+		      cli::error::option_already_added_as);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE(pass_through);
+
+namespace
+{
+    const dictionary wrapper_options {
+	option {
+	    "-v",
+	    "--verbose"
+	},
+
+	option {
+	    "-o",
+	    "--output",
+	    {},
+	    {},
+	    option::required::not_required,
+	    option::arguments::has_arguments
+	}
+    };
+}
+
+BOOST_AUTO_TEST_CASE(pass_through_disabled_by_default)
+{
+    parser parser {wrapper_options};
+
+    BOOST_TEST(not parser.passes_through());
+
+    const char* argv[] = {
+	"",
+	"--color",
+	nullptr
+    };
+
+    BOOST_CHECK_THROW(parser.parse_command_line(std::size(argv), argv),
+		      cli::error::unrecognized_option);
+}
+
+BOOST_AUTO_TEST_CASE(pass_unknown_options_through)
+{
+    parser parser {wrapper_options};
+
+    parser.passes_through(true);
+
+    const char* argv[] = {
+	"",
+	"input.c",
+	"-v",
+	"--color=auto",
+	"--jobs",
+	"4",
+	"main.c",
+	"-o",
+	"out",
+	"-x",
+	"--",
+	"y",
+	nullptr
+    };
+
+    BOOST_CHECK_NO_THROW(parser.parse_command_line(std::size(argv), argv));
+
+    BOOST_REQUIRE_EQUAL(parser.options().size(), 3);
+    BOOST_CHECK_EQUAL(parser.options()[0], "-v");
+    BOOST_CHECK_EQUAL(parser.options()[1], "-o");
+    BOOST_CHECK_EQUAL(parser.options()[2], "out");
+
+    BOOST_REQUIRE_EQUAL(parser.positional_options().size(), 1);
+    BOOST_CHECK_EQUAL(parser.positional_options()[0], "input.c");
+
+    // Runs refer into argv itself, one per stretch of passed tokens.
+    auto& runs = parser.pass_through();
+
+    BOOST_REQUIRE_EQUAL(runs.size(), 2);
+
+    BOOST_TEST((runs[0].data() == argv + 3));
+    BOOST_CHECK_EQUAL(runs[0].size(), 4);
+
+    BOOST_TEST((runs[1].data() == argv + 9));
+    BOOST_CHECK_EQUAL(runs[1].size(), 3);
+
+    const char* known[] = {
+	"",
+	"-v",
+	nullptr
+    };
+
+    parser.parse_command_line(std::size(known), known);
+
+    BOOST_TEST(parser.pass_through().empty());
+}
+
+BOOST_AUTO_TEST_CASE(report_pass_through_events)
+{
+    parser parser {wrapper_options};
+
+    parser.passes_through(true);
+
+    const char* argv[] = {
+	"",
+	"--color",
+	"auto",
+	"-v",
+	"file",
+	nullptr
+    };
+
+    std::vector<parse_event> events;
+
+    parser.parse_command_line(
+	std::size(argv),
+	argv,
+	[&](const parse_event& event)
+	{
+	    events.emplace_back(event);
+	});
+
+    BOOST_REQUIRE_EQUAL(events.size(), 4);
+
+    BOOST_TEST((events[0].type == parse_event::kind::pass_through));
+    BOOST_TEST((events[0].option == nullptr));
+    BOOST_CHECK_EQUAL(events[0].value, "--color");
+
+    BOOST_TEST((events[1].type == parse_event::kind::pass_through));
+    BOOST_CHECK_EQUAL(events[1].index, 2);
+
+    BOOST_TEST((events[2].type == parse_event::kind::option));
+
+    BOOST_TEST((events[3].type == parse_event::kind::positional));
+    BOOST_CHECK_EQUAL(events[3].value, "file");
+}
+
+BOOST_AUTO_TEST_CASE(validate_with_pass_through)
+{
+    parser parser {wrapper_options};
+
+    parser.passes_through(true);
+
+    const char* argv[] = {
+	"",
+	"--color",
+	"-o",
+	nullptr
+    };
+
+    auto diagnostic = parser.validate(std::size(argv), argv);
+
+    BOOST_REQUIRE(diagnostic);
+
+    BOOST_TEST((diagnostic->type ==
+		diagnostic::kind::option_expects_argument));
+    BOOST_CHECK_EQUAL(diagnostic->index, 2);
+
+    argv[2] = nullptr;
+
+    BOOST_TEST(not parser.validate(std::size(argv), argv));
+}
+
+BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE(lookup_strategy);
+
+const dictionary strategy_dictionary {
+    option {"-h", "--help"},
+    option {{},   "--verbose"},
+
+    option {
+	"-f",
+	"--file",
+	{},
+	{},
+	option::required::not_required,
+	option::arguments::has_arguments
+    }
+};
+
+BOOST_AUTO_TEST_CASE(override_lookup_strategy)
+{
+    parser parser {strategy_dictionary};
+
+    BOOST_TEST((parser.lookup_strategy() == grammar::lookup_strategy::linear));
+
+    parser.lookup_strategy(grammar::lookup_strategy::trie);
+
+    BOOST_TEST((parser.lookup_strategy() == grammar::lookup_strategy::trie));
+
+    const char* argv[] = {
+	"",
+	"--verbose",
+	"--file",
+	"a.txt",
+	nullptr
+    };
+
+    parser.parse_command_line(std::size(argv), argv);
+
+    BOOST_TEST(parser.contains("--verbose").has_value());
+    BOOST_TEST(parser.contains("--file").has_value());
+
+    BOOST_CHECK_EQUAL(parser.options().size(), 3);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE(parse_command_line_with_handler);
+
+BOOST_AUTO_TEST_CASE(parse_events_in_command_line_order)
+{
+    const option file {
+	"-f",
+	"--file",
+	{},
+	{},
+	option::required::not_required,
+	option::arguments::has_arguments
+    };
+
+    const option help {
+	"-h",
+	"--help"
+    };
+
+    parser parser {
+	dictionary {
+	    file,
+	    help
+	}
+    };
+
+    const char* argv[] = {
+	"",
+	"-f",
+	"a.txt",
+	"data.dat",
+	"--file=b.txt",
+	"-h",
+	nullptr
+    };
+
+    std::vector<parse_event> events;
+
+    BOOST_CHECK_NO_THROW(
+	parser.parse_command_line(
+	    std::size(argv),
+	    argv,
+	    [&](const parse_event& event)
+	    {
+		events.emplace_back(event);
+	    }));
+
+    BOOST_REQUIRE_EQUAL(events.size(), 6);
+
+    BOOST_TEST((events[0].type == parse_event::kind::option));
+    BOOST_TEST((*events[0].option == file));
+    BOOST_CHECK_EQUAL(events[0].index, 1);
+    BOOST_CHECK_EQUAL(events[0].value, "-f");
+
+    BOOST_TEST((events[1].type == parse_event::kind::argument));
+    BOOST_TEST((*events[1].option == file));
+    BOOST_CHECK_EQUAL(events[1].index, 2);
+    BOOST_CHECK_EQUAL(events[1].value, "a.txt");
+
+    BOOST_TEST((events[2].type == parse_event::kind::positional));
+    BOOST_TEST((events[2].option == nullptr));
+    BOOST_CHECK_EQUAL(events[2].index, 3);
+    BOOST_CHECK_EQUAL(events[2].value, "data.dat");
+
+    BOOST_TEST((events[3].type == parse_event::kind::option));
+    BOOST_CHECK_EQUAL(events[3].index, 4);
+    BOOST_CHECK_EQUAL(events[3].value, "--file");
+
+    BOOST_TEST((events[4].type == parse_event::kind::argument));
+    BOOST_CHECK_EQUAL(events[4].index, 4);
+    BOOST_CHECK_EQUAL(events[4].value, "b.txt");
+
+    BOOST_TEST((events[5].type == parse_event::kind::option));
+    BOOST_TEST((*events[5].option == help));
+    BOOST_CHECK_EQUAL(events[5].index, 5);
+    BOOST_CHECK_EQUAL(events[5].value, "-h");
+}
+
+BOOST_AUTO_TEST_CASE(parse_without_building_parsed_command_line)
+{
+    parser parser {
+	dictionary {
+	    option {
+		"-h",
+		"--help"
+	    }
+	}
+    };
+
+    const char* argv[] = {
+	"",
+	"-h",
+	nullptr
+    };
+
+    int count = 0;
+
+    parser.parse_command_line(
+	std::size(argv), argv, [&](auto&&) { ++count; });
+
+    BOOST_CHECK_EQUAL(count, 1);
+
+    BOOST_TEST(parser.options().empty());
+    BOOST_TEST(parser.positional_options().empty());
+}
+
+BOOST_AUTO_TEST_CASE(parse_invalid_command_line)
+{
+    parser parser {
+	dictionary {
+	    option {
+		"-h",
+		"--help"
+	    },
+
+	    option {
+		"-o",
+		"--output",
+		{},
+		{},
+		option::required::required,
+		option::arguments::has_arguments
+	    }
+	}
+    };
+
+    auto ignore = [](auto&&) {};
+
+    const char* argv_1[] = {
+	"",
+	"-x",
+	nullptr
+    };
+
+    BOOST_CHECK_THROW(
+	parser.parse_command_line(std::size(argv_1), argv_1, ignore),
+	cli::error::unrecognized_option);
+
+    const char* argv_2[] = {
+	"",
+	"-h",
+	"--help",
+	nullptr
+    };
+
+    BOOST_CHECK_THROW(
+	parser.parse_command_line(std::size(argv_2), argv_2, ignore),
+	cli::error::option_already_added_as);
+
+    const char* argv_3[] = {
+	"",
+	"-o",
+	nullptr
+    };
+
+    BOOST_CHECK_THROW(
+	parser.parse_command_line(std::size(argv_3), argv_3, ignore),
+	cli::error::option_expects_argument);
+
+    const char* argv_4[] = {
+	"",
+	"-h",
+	nullptr
+    };
+
+    BOOST_CHECK_THROW(
+	parser.parse_command_line(std::size(argv_4), argv_4, ignore),
+	cli::error::option_is_required_but_not_added);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE(events);
+
+static_assert(std::ranges::input_range<parser::event_range>);
+
+BOOST_AUTO_TEST_CASE(stop_after_first_match)
+{
+    const option help {
+	"-h",
+	"--help"
+    };
+
+    parser parser {
+	dictionary {
+	    help
+	}
+    };
+
+    const char* argv[] = {
+	"",
+	"--help",
+	"-x",
+	nullptr
+    };
+
+    bool found = false;
+
+    BOOST_CHECK_NO_THROW(
+	for (auto&& event : parser.events(std::size(argv), argv))
+	{
+	    if (event.type == parse_event::kind::option &&
+		*event.option == help)
+	    {
+		found = true;
+
+		break;
+	    }
+	});
+
+    BOOST_TEST(found);
+}
+
+BOOST_AUTO_TEST_CASE(iterate_all_events)
+{
+    parser parser {
+	dictionary {
+	    option {
+		"-f",
+		"--file",
+		{},
+		{},
+		option::required::not_required,
+		option::arguments::has_arguments
+	    }
+	}
+    };
+
+    const char* argv[] = {
+	"",
+	"--file=a.txt",
+	"b.txt",
+	nullptr
+    };
+
+    std::vector<std::string_view> values;
+
+    for (auto&& event : parser.events(std::size(argv), argv))
+    {
+	values.emplace_back(event.value);
+    }
+
+    BOOST_REQUIRE_EQUAL(values.size(), 3);
+
+    BOOST_CHECK_EQUAL(values[0], "--file");
+    BOOST_CHECK_EQUAL(values[1], "a.txt");
+    BOOST_CHECK_EQUAL(values[2], "b.txt");
+}
+
+BOOST_AUTO_TEST_CASE(check_required_options)
+{
+    parser parser {
+	dictionary {
+	    option {
+		"-h",
+		"--help"
+	    },
+
+	    option {
+		"-o",
+		"--output",
+		{},
+		{},
+		option::required::required,
+		option::arguments::has_arguments
+	    }
+	}
+    };
+
+    const char* argv_1[] = {
+	"",
+	"-h",
+	nullptr
+    };
+
+    auto events_1 = parser.events(std::size(argv_1), argv_1);
+
+    BOOST_TEST((events_1.begin()->value == "-h"));
+
+    BOOST_CHECK_THROW(events_1.check_required_options(),
+		      cli::error::option_is_required_but_not_added);
+
+    const char* argv_2[] = {
+	"",
+	"-h",
+	"-o",
+	"a.out",
+	nullptr
+    };
+
+    auto events_2 = parser.events(std::size(argv_2), argv_2);
+
+    BOOST_TEST((events_2.begin()->value == "-h"));
+
+    BOOST_CHECK_NO_THROW(events_2.check_required_options());
+}
+
+BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE(validate);
+
+const dictionary validate_dictionary {
+    option {"-h", "--help"},
+
+    option {
+	"-i",
+	"--interface",
+	{},
+	{},
+	option::required::required,
+	option::arguments::has_arguments
+    }
+};
+
+BOOST_AUTO_TEST_CASE(validate_command_lines)
+{
+    const parser parser {validate_dictionary};
+
+    const char* valid[] = {"", "-h", "-i", "eth0", "data.dat", nullptr};
+
+    BOOST_TEST(not parser.validate(std::size(valid), valid).has_value());
+
+    BOOST_TEST(parser.options().empty());
+
+    using kind = diagnostic::kind;
+
+    const char* unknown[] = {"", "-h", "--unknown", "-h", nullptr};
+
+    auto diagnostic = parser.validate(std::size(unknown), unknown);
+
+    BOOST_REQUIRE(diagnostic.has_value());
+    BOOST_TEST((diagnostic->type == kind::unrecognized_option));
+    BOOST_CHECK_EQUAL(diagnostic->index, 2);
+
+    const char* repeated[] = {"", "-h", "-i", "eth0", "--help", nullptr};
+
+    diagnostic = parser.validate(std::size(repeated), repeated);
+
+    BOOST_REQUIRE(diagnostic.has_value());
+    BOOST_TEST((diagnostic->type == kind::option_already_added_as));
+    BOOST_CHECK_EQUAL(diagnostic->index, 4);
+    BOOST_CHECK_EQUAL(diagnostic->id,    0);
+
+    const char* no_argument[] = {"", "-i", "-h", nullptr};
+
+    diagnostic = parser.validate(std::size(no_argument), no_argument);
+
+    BOOST_REQUIRE(diagnostic.has_value());
+    BOOST_TEST((diagnostic->type == kind::option_expects_argument));
+    BOOST_CHECK_EQUAL(diagnostic->index, 1);
+
+    const char* empty_argument[] = {"", "--interface=", nullptr};
+
+    diagnostic = parser.validate(std::size(empty_argument), empty_argument);
+
+    BOOST_REQUIRE(diagnostic.has_value());
+    BOOST_TEST((diagnostic->type == kind::option_expects_argument));
+
+    const char* missing[] = {"", "-h", nullptr};
+
+    diagnostic = parser.validate(std::size(missing), missing);
+
+    BOOST_REQUIRE(diagnostic.has_value());
+    BOOST_TEST((diagnostic->type == kind::option_is_required_but_not_added));
+    BOOST_CHECK_EQUAL(diagnostic->index, diagnostic::no_index);
+    BOOST_CHECK_EQUAL(diagnostic->id,    1);
+}
+
+BOOST_AUTO_TEST_CASE(validate_in_windows)
+{
+    std::vector<std::string> names;
+
+    for (int i = 0; i < 3000; ++i)
+    {
+	names.emplace_back("--option-" + std::to_string(i));
+    }
+
+    std::vector<option> options;
+
+    for (auto&& name : names)
+    {
+	options.emplace_back(
+	    std::string_view {},
+	    name,
+	    std::string_view {},
+	    std::string_view {},
+	    name == "--option-2500" ?
+		option::required::required :
+		option::required::not_required);
+    }
+
+    const parser parser {dictionary {options.cbegin(), options.cend()}};
+
+    const char* valid[] = {"", "--option-2500", "--option-10", nullptr};
+
+    BOOST_TEST(not parser.validate(std::size(valid), valid).has_value());
+
+    const char* missing[] = {"", "--option-2000", nullptr};
+
+    auto diagnostic = parser.validate(std::size(missing), missing);
+
+    BOOST_REQUIRE(diagnostic.has_value());
+    BOOST_CHECK_EQUAL(diagnostic->id, 2500);
+
+    const char* repeated[] = {
+	"",
+	"--option-2500",
+	"--option-2999",
+	"--option-1",
+	"--option-2999",
+	"--option-1",
+	nullptr
+    };
+
+    diagnostic = parser.validate(std::size(repeated), repeated);
+
+    BOOST_REQUIRE(diagnostic.has_value());
+    BOOST_TEST((diagnostic->type ==
+		diagnostic::kind::option_already_added_as));
+    BOOST_CHECK_EQUAL(diagnostic->index, 4);
+    BOOST_CHECK_EQUAL(diagnostic->id,    2999);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,355 @@
+#define BOOST_TEST_MODULE parser_policies
+
+#include <string_view>
+#include <cstring>
+#include <memory>
+
+#include <boost/test/unit_test.hpp>
+
+#include "core/parser_policies.hpp"
+#include "core/diagnostic.hpp"
+#include "core/dictionary.hpp"
+#include "core/option_map.hpp"
+#include "core/grammar.hpp"
+#include "core/option.hpp"
+#include "core/parser.hpp"
+
+#include "error/option_is_required_but_not_added.hpp"
+#include "error/unrecognized_option.hpp"
+
+using namespace cli::core;
+
+namespace
+{
+    using flat_parser = basic_parser<
+	hash_lookup,
+	flat_storage<4>,
+	throw_errors,
+	std::allocator<std::byte>
+    >;
+
+    using expect_parser = basic_parser<
+	automatic_lookup,
+	vector_storage,
+	expect_errors,
+	std::allocator<std::byte>
+    >;
+
+    const dictionary interfaces {
+	option {"-h", "--help"},
+
+	option {
+	    "-i",
+	    "--interface",
+	    {},
+	    {},
+	    option::required::required,
+	    option::arguments::has_arguments
+	}
+    };
+}
+
+namespace
+{
+    template<typename LookupPolicy>
+    void check_lookup_policy()
+    {
+	basic_parser<
+	    LookupPolicy,
+	    vector_storage,
+	    throw_errors,
+	    std::allocator<std::byte>
+	> parser {interfaces};
+
+	parser.abbreviations(true);
+
+	const char* argv[] = {"", "--help", "--inter", "eth0", "-i", "ppp0"};
+
+	parser.parse_command_line(std::size(argv), argv);
+
+	BOOST_CHECK_EQUAL(parser.options().size(), 5);
+
+	const char* unknown[] = {"", "--interfaces"};
+
+	BOOST_CHECK_THROW(
+	    parser.parse_command_line(std::size(unknown), unknown),
+	    cli::error::unrecognized_option);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE(lookup_policy);
+
+BOOST_AUTO_TEST_CASE(resolve_with_every_policy)
+{
+    check_lookup_policy<automatic_lookup>();
+    check_lookup_policy<linear_lookup>();
+    check_lookup_policy<binary_search_lookup>();
+    check_lookup_policy<hash_lookup>();
+    check_lookup_policy<trie_lookup>();
+}
+
+BOOST_AUTO_TEST_CASE(compile_with_policy_strategy)
+{
+    flat_parser parser {interfaces};
+
+    BOOST_TEST((parser.lookup_strategy() == grammar::lookup_strategy::hash));
+
+    parser.lookup_strategy(grammar::lookup_strategy::linear);
+
+    BOOST_TEST((parser.lookup_strategy() == grammar::lookup_strategy::linear));
+}
+
+BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE(storage_policy);
+
+BOOST_AUTO_TEST_CASE(parse_into_flat_storage)
+{
+    flat_parser parser {interfaces};
+
+    const char* argv[] = {
+	"",
+	"-h",
+	"--interface=eth0",
+	"data.dat",
+	nullptr
+    };
+
+    parser.parse_command_line(std::size(argv), argv);
+
+    BOOST_REQUIRE_EQUAL(parser.options().size(), 2);
+
+    BOOST_CHECK_EQUAL(parser.options()[0], "-h");
+    BOOST_CHECK_EQUAL(parser.options()[1], "--interface=eth0");
+
+    BOOST_CHECK_EQUAL(parser.positional_options().size(), 1);
+
+    BOOST_TEST(parser.positional_options().is_inline());
+
+    option_map map {interfaces};
+
+    map.add_command_line_options(parser.options());
+
+    BOOST_CHECK_EQUAL(map["--interface"].front(), "eth0");
+}
+
+BOOST_AUTO_TEST_CASE(spill_flat_storage)
+{
+    flat_parser parser {interfaces};
+
+    const char* argv[] = {
+	"",
+	"-i",
+	"eth0",
+	"-i",
+	"eth1",
+	"-i",
+	"eth2",
+	nullptr
+    };
+
+    parser.parse_command_line(std::size(argv), argv);
+
+    BOOST_REQUIRE_EQUAL(parser.options().size(), 6);
+
+    BOOST_CHECK_EQUAL(parser.options()[5], "eth2");
+
+    flat_parser copy {parser};
+
+    BOOST_REQUIRE_EQUAL(copy.options().size(), 6);
+
+    BOOST_CHECK_EQUAL(copy.options()[4], "-i");
+}
+
+BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE(error_policy);
+
+BOOST_AUTO_TEST_CASE(throw_on_error)
+{
+    flat_parser parser {interfaces};
+
+    const char* argv[] = {
+	"",
+	"--unknown",
+	nullptr
+    };
+
+    BOOST_CHECK_THROW(parser.parse_command_line(std::size(argv), argv),
+		      cli::error::unrecognized_option);
+}
+
+BOOST_AUTO_TEST_CASE(expect_errors)
+{
+    expect_parser parser {interfaces};
+
+    const char* argv[] = {
+	"",
+	"-h",
+	"--unknown",
+	"-i",
+	nullptr
+    };
+
+    BOOST_TEST(not parser.parse_command_line(std::size(argv), argv));
+
+    BOOST_REQUIRE(parser.errors().error());
+
+    BOOST_TEST((parser.errors().diagnostic().type ==
+		diagnostic::kind::unrecognized_option));
+
+    BOOST_CHECK_EQUAL(parser.errors().diagnostic().index, 2);
+
+    BOOST_TEST(std::strstr(parser.errors().error()->what(),
+			   "unrecognized option --unknown"));
+
+    BOOST_TEST(parser.errors().error_as<cli::error::unrecognized_option>());
+    BOOST_TEST(not parser.errors().error_as<
+	       cli::error::option_is_required_but_not_added>());
+
+    BOOST_CHECK_EQUAL(parser.options().size(), 1);
+
+    const char* missing[] = {
+	"",
+	"-h",
+	nullptr
+    };
+
+    BOOST_TEST(not parser.parse_command_line(std::size(missing), missing));
+
+    BOOST_TEST(std::strstr(parser.errors().error()->what(),
+			   "-i"));
+
+    BOOST_TEST(parser.errors().error_as<
+	       cli::error::option_is_required_but_not_added>());
+
+    const char* valid[] = {
+	"",
+	"-i",
+	"eth0",
+	nullptr
+    };
+
+    BOOST_TEST(parser.parse_command_line(std::size(valid), valid));
+
+    BOOST_TEST(not parser.errors().error());
+}
+
+BOOST_AUTO_TEST_CASE(collect_errors)
+{
+    const dictionary dictionary {
+	option {"-h", "--help"},
+
+	option {
+	    "-i",
+	    "--interface",
+	    {},
+	    {},
+	    option::required::required,
+	    option::arguments::has_arguments
+	},
+
+	option {
+	    "-o",
+	    "--output",
+	    {},
+	    {},
+	    option::required::required,
+	    option::arguments::has_arguments
+	},
+
+	option {{}, "--version"},
+	option {{}, "--verbose"}
+    };
+
+    basic_parser<
+	automatic_lookup,
+	vector_storage,
+	cli::core::collect_errors<8>,
+	std::allocator<std::byte>
+    > parser {dictionary};
+
+    parser.abbreviations(true);
+
+    const char* argv[] = {
+	"",
+	"--unknown",
+	"-h",
+	"--ver",
+	"data.dat",
+	"--help",
+	"--interface=",
+	"-x",
+	nullptr
+    };
+
+    auto diagnostics = parser.parse_command_line(std::size(argv), argv);
+
+    BOOST_REQUIRE_EQUAL(diagnostics.size(), 6);
+
+    using kind = diagnostic::kind;
+
+    BOOST_TEST((diagnostics[0].type == kind::unrecognized_option));
+    BOOST_CHECK_EQUAL(diagnostics[0].index, 1);
+    BOOST_CHECK_EQUAL(diagnostics[0].id,    grammar::npos);
+
+    BOOST_TEST((diagnostics[1].type == kind::ambiguous_option));
+    BOOST_CHECK_EQUAL(diagnostics[1].index, 3);
+
+    BOOST_TEST((diagnostics[2].type == kind::option_already_added_as));
+    BOOST_CHECK_EQUAL(diagnostics[2].index, 5);
+    BOOST_CHECK_EQUAL(diagnostics[2].id,    0);
+
+    BOOST_TEST((diagnostics[3].type == kind::option_expects_argument));
+    BOOST_CHECK_EQUAL(diagnostics[3].index, 6);
+    BOOST_CHECK_EQUAL(diagnostics[3].id,    1);
+
+    BOOST_TEST((diagnostics[4].type == kind::unrecognized_option));
+    BOOST_CHECK_EQUAL(diagnostics[4].index, 7);
+
+    BOOST_TEST((diagnostics[5].type == kind::option_is_required_but_not_added));
+    BOOST_CHECK_EQUAL(diagnostics[5].index, diagnostic::no_index);
+    BOOST_CHECK_EQUAL(diagnostics[5].id,    2);
+
+    BOOST_CHECK_EQUAL(parser.errors().dropped(), 0);
+
+    BOOST_CHECK_EQUAL(parser.positional_options().size(), 1);
+
+    const char* valid[] = {
+	"",
+	"-i",
+	"eth0",
+	"-o",
+	"out.dat",
+	nullptr
+    };
+
+    BOOST_TEST(parser.parse_command_line(std::size(valid), valid).empty());
+}
+
+BOOST_AUTO_TEST_CASE(drop_diagnostics_beyond_buffer)
+{
+    basic_parser<
+	automatic_lookup,
+	vector_storage,
+	cli::core::collect_errors<1>,
+	std::allocator<std::byte>
+    > parser {interfaces};
+
+    const char* argv[] = {
+	"",
+	"-x",
+	"-y",
+	nullptr
+    };
+
+    auto diagnostics = parser.parse_command_line(std::size(argv), argv);
+
+    BOOST_REQUIRE_EQUAL(diagnostics.size(), 1);
+
+    BOOST_CHECK_EQUAL(diagnostics[0].index, 1);
+
+    BOOST_CHECK_EQUAL(parser.errors().dropped(), 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,150 @@
+#define BOOST_TEST_MODULE reloadable_options
+
+#include <string_view>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "core/reloadable_options.hpp"
+#include "core/dictionary.hpp"
+#include "core/option.hpp"
+
+#include "error/unrecognized_option.hpp"
+
+using namespace cli::core;
+
+namespace
+{
+    const option level {
+	"-l",
+	"--level",
+	"-l, --level",
+	{},
+	option::required::not_required,
+	option::arguments::has_arguments
+    };
+
+    const option verbose {"-v", "--verbose", "-v, --verbose"};
+
+    const dictionary reload_dictionary {level, verbose};
+}
+
+BOOST_AUTO_TEST_SUITE(reload);
+
+BOOST_AUTO_TEST_CASE(publish_and_diff)
+{
+    reloadable_options options {reload_dictionary};
+
+    BOOST_TEST(not options.read()->contains("-v").has_value());
+
+    std::string value = "1";
+
+    {
+	const char* argv[] = {"daemon", "-v", "-l", value.c_str(), "input"};
+
+	auto changed = options.reload(5, argv);
+
+	BOOST_REQUIRE_EQUAL(changed.size(), 2);
+    }
+
+    // The published snapshot owns its tokens.
+    value = "#";
+
+    {
+	auto reader = options.read();
+
+	BOOST_TEST(reader->contains("-v").has_value());
+	BOOST_TEST((*reader)["--level"].front() == "1");
+
+	BOOST_REQUIRE_EQUAL(reader.positional_options().size(), 1);
+	BOOST_TEST(reader.positional_options()[0] == "input");
+    }
+
+    const char* argv[] = {"daemon", "-v", "-l", "2"};
+
+    auto changed = options.reload(4, argv);
+
+    BOOST_REQUIRE_EQUAL(changed.size(), 1);
+    BOOST_TEST((options.option_of(changed[0]) == level));
+
+    BOOST_TEST(options.generation() == 2);
+}
+
+BOOST_AUTO_TEST_CASE(keep_snapshot_on_error)
+{
+    reloadable_options options {reload_dictionary};
+
+    const char* good[] = {"daemon", "-v"};
+    const char* bad[]  = {"daemon", "--unknown"};
+
+    options.reload(2, good);
+
+    BOOST_CHECK_THROW(options.reload(2, bad), cli::error::unrecognized_option);
+
+    BOOST_TEST(options.read()->contains("-v").has_value());
+    BOOST_TEST(options.generation() == 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE(concurrency);
+
+BOOST_AUTO_TEST_CASE(read_while_reloading)
+{
+    reloadable_options options {reload_dictionary};
+
+    const std::vector<std::string> values {"alpha", "beta", "gamma", "delta"};
+
+    std::atomic<bool>        done {false};
+    std::atomic<std::size_t> torn {0};
+
+    std::vector<std::thread> readers;
+
+    for (int i = 0; i < 4; ++i)
+    {
+	readers.emplace_back([&]
+	{
+	    while (not done.load())
+	    {
+		auto reader = options.read();
+
+		if (reader->contains("-l"))
+		{
+		    auto value = (*reader)["-l"].front();
+
+		    if (value != "alpha" && value != "beta" &&
+			value != "gamma" && value != "delta")
+		    {
+			++torn;
+		    }
+		}
+
+		std::this_thread::yield();
+	    }
+	});
+    }
+
+    for (int i = 0; i < 300; ++i)
+    {
+	std::string value = values[i % values.size()];
+
+	const char* argv[] = {"daemon", "-l", value.c_str()};
+
+	options.reload(3, argv);
+    }
+
+    done = true;
+
+    for (auto&& reader : readers)
+    {
+	reader.join();
+    }
+
+    BOOST_TEST(torn.load() == 0);
+    BOOST_TEST(options.generation() == 300);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,241 @@
+#define BOOST_TEST_MODULE shared_dictionary
+
+#include <utility>
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include "core/shared_dictionary.hpp"
+#include "core/dictionary.hpp"
+#include "core/option_map.hpp"
+#include "core/option.hpp"
+#include "core/parser.hpp"
+
+using namespace cli::core;
+
+BOOST_AUTO_TEST_SUITE(constructor);
+
+BOOST_AUTO_TEST_CASE(default_constructor)
+{
+    BOOST_TEST(shared_dictionary().empty());
+}
+
+BOOST_AUTO_TEST_CASE(move_constructor)
+{
+    dictionary dictionary {
+	option {
+	    "-h",
+	    "--help"
+	}
+    };
+
+    shared_dictionary shared {std::move(dictionary)};
+
+    BOOST_TEST(dictionary.empty());
+
+    BOOST_CHECK_EQUAL(shared.size(), 1);
+
+    BOOST_TEST(shared.contains("--help"));
+}
+
+BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE(intern);
+
+BOOST_AUTO_TEST_CASE(identical_dictionaries)
+{
+    const dictionary dictionary {
+	option {
+	    "-f",
+	    "--file",
+	    "-f, --file",
+	    "add file",
+	    option::required::not_required,
+	    option::arguments::has_arguments
+	}
+    };
+
+    shared_dictionary shared_1 {dictionary};
+    shared_dictionary shared_2 {dictionary};
+
+    BOOST_TEST(shared_1.shares(shared_2));
+
+    BOOST_TEST((shared_1 == shared_2));
+}
+
+BOOST_AUTO_TEST_CASE(dictionaries_with_different_flags)
+{
+    shared_dictionary shared_1 {
+	dictionary {
+	    option {
+		"-f",
+		"--file"
+	    }
+	}
+    };
+
+    shared_dictionary shared_2 {
+	dictionary {
+	    option {
+		"-f",
+		"--file",
+		{},
+		{},
+		option::required::not_required,
+		option::arguments::has_arguments
+	    }
+	}
+    };
+
+    BOOST_TEST(not shared_1.shares(shared_2));
+
+    BOOST_TEST(not shared_1["-f"].has_arguments());
+    BOOST_TEST(shared_2["-f"].has_arguments());
+}
+
+BOOST_AUTO_TEST_CASE(dictionaries_with_equality_validators)
+{
+    const dictionary dictionary {
+	option {
+	    "-v",
+	    "--verbose",
+	    {},
+	    {},
+	    option::required::not_required,
+	    option::arguments::no_arguments,
+	    [](auto&& option_name)
+	    {
+		return option_name == "--no-verbose";
+	    }
+	}
+    };
+
+    shared_dictionary shared_1 {dictionary};
+    shared_dictionary shared_2 {dictionary};
+
+    BOOST_TEST(not shared_1.shares(shared_2));
+
+    BOOST_CHECK_EQUAL(shared_1.fingerprint(), shared_2.fingerprint());
+}
+
+BOOST_AUTO_TEST_CASE(entries_own_their_names)
+{
+    std::string long_name {"--verbose"};
+
+    const shared_dictionary shared_1 {
+	dictionary {
+	    option {
+		"-v",
+		long_name
+	    }
+	}
+    };
+
+    // The first owner reuses its storage: the entry must not see it.
+    long_name.assign(long_name.size(), 'x');
+
+    parser parser {
+	dictionary {
+	    option {
+		"-v",
+		"--verbose"
+	    }
+	}
+    };
+
+    BOOST_TEST(parser.contains(shared_1));
+
+    BOOST_CHECK_EQUAL(shared_1["-v"].long_name(), "--verbose");
+
+    const char* argv[] = {
+	"",
+	"--verbose",
+	nullptr
+    };
+
+    for (auto&& event : parser.events(std::size(argv) - 1, argv))
+    {
+	BOOST_REQUIRE(event.option);
+	BOOST_CHECK_EQUAL(event.option->long_name(), "--verbose");
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE(fingerprint);
+
+BOOST_AUTO_TEST_CASE(fingerprint_of_equal_dictionaries)
+{
+    const dictionary dictionary_1 {
+	option {
+	    "-h",
+	    "--help"
+	}
+    };
+
+    const dictionary dictionary_2 {
+	option {
+	    "-h",
+	    "--help",
+	    "-h, --help",
+	    "print help"
+	}
+    };
+
+    const dictionary dictionary_3 {
+	option {
+	    "-h"
+	}
+    };
+
+    BOOST_CHECK_EQUAL(shared_dictionary::fingerprint(dictionary_1),
+		      shared_dictionary::fingerprint(dictionary_2));
+
+    BOOST_CHECK_NE(shared_dictionary::fingerprint(dictionary_1),
+		   shared_dictionary::fingerprint(dictionary_3));
+}
+
+BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE(owners);
+
+BOOST_AUTO_TEST_CASE(parser_and_option_map)
+{
+    const shared_dictionary shared {
+	dictionary {
+	    option {
+		"-h",
+		"--help"
+	    }
+	}
+    };
+
+    parser parser;
+
+    parser.add_dictionary(shared);
+    parser.add_dictionary(shared);
+
+    BOOST_TEST(parser.contains(shared));
+    BOOST_TEST(parser.contains(*shared));
+
+    option_map map;
+
+    map.add_dictionary(shared);
+
+    BOOST_TEST(map.contains(shared));
+    BOOST_TEST(map.contains(*shared));
+
+    const char* argv[] = {
+	"",
+	"-h",
+	nullptr
+    };
+
+    parser.parse_command_line(std::size(argv), argv);
+
+    map.add_command_line_options(parser.options());
+
+    BOOST_TEST(map.contains("--help").has_value());
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,21 @@
+#define BOOST_TEST_MODULE ambiguous_option
+
+#include <boost/test/unit_test.hpp>
+
+#include "error/ambiguous_option.hpp"
+
+using namespace cli::error;
+
+BOOST_AUTO_TEST_SUITE(constructor);
+
+BOOST_AUTO_TEST_CASE(parameterized_constructor)
+{
+    BOOST_CHECK_EQUAL(
+	ambiguous_option("--verb").what(), "ambiguous option --verb");
+
+    BOOST_CHECK_EQUAL(
+	ambiguous_option("--verb", "where").what(),
+	"where: ambiguous option --verb");
+}
+
+BOOST_AUTO_TEST_SUITE_END();
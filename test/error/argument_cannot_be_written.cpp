@@ -0,0 +1,22 @@
+#define BOOST_TEST_MODULE argument_cannot_be_written
+
+#include <boost/test/unit_test.hpp>
+
+#include "error/argument_cannot_be_written.hpp"
+
+using namespace cli::error;
+
+BOOST_AUTO_TEST_SUITE(constructor);
+
+BOOST_AUTO_TEST_CASE(parameterized_constructor)
+{
+    BOOST_CHECK_EQUAL(
+	argument_cannot_be_written("-a,b").what(),
+	"cannot write argument -a,b");
+
+    BOOST_CHECK_EQUAL(
+	argument_cannot_be_written("-a,b", "where").what(),
+	"where: cannot write argument -a,b");
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,22 @@
+#define BOOST_TEST_MODULE argument_without_option
+
+#include <boost/test/unit_test.hpp>
+
+#include "error/argument_without_option.hpp"
+
+using namespace cli::error;
+
+BOOST_AUTO_TEST_SUITE(constructor);
+
+BOOST_AUTO_TEST_CASE(parameterized_constructor)
+{
+    BOOST_CHECK_EQUAL(
+        argument_without_option("eth0").what(),
+	"argument eth0 without option");
+
+    BOOST_CHECK_EQUAL(
+        argument_without_option("eth0", "where").what(),
+	"where: argument eth0 without option");
+}
+
+BOOST_AUTO_TEST_SUITE_END();
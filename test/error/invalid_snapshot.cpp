@@ -0,0 +1,22 @@
+#define BOOST_TEST_MODULE invalid_snapshot
+
+#include <boost/test/unit_test.hpp>
+
+#include "error/invalid_snapshot.hpp"
+
+using namespace cli::error;
+
+BOOST_AUTO_TEST_SUITE(constructor);
+
+BOOST_AUTO_TEST_CASE(parameterized_constructor)
+{
+    BOOST_CHECK_EQUAL(
+	invalid_snapshot("grammar mismatch").what(),
+	"invalid snapshot: grammar mismatch");
+
+    BOOST_CHECK_EQUAL(
+	invalid_snapshot("grammar mismatch", "where").what(),
+	"where: invalid snapshot: grammar mismatch");
+}
+
+BOOST_AUTO_TEST_SUITE_END();
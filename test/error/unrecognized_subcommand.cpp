@@ -0,0 +1,22 @@
+#define BOOST_TEST_MODULE unrecognized_subcommand
+
+#include <boost/test/unit_test.hpp>
+
+#include "error/unrecognized_subcommand.hpp"
+
+using namespace cli::error;
+
+BOOST_AUTO_TEST_SUITE(constructor);
+
+BOOST_AUTO_TEST_CASE(parameterized_constructor)
+{
+    BOOST_CHECK_EQUAL(
+	unrecognized_subcommand("push").what(),
+	"unrecognized subcommand push");
+
+    BOOST_CHECK_EQUAL(
+	unrecognized_subcommand("push", "where").what(),
+	"where: unrecognized subcommand push");
+}
+
+BOOST_AUTO_TEST_SUITE_END();
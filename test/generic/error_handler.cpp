@@ -0,0 +1,90 @@
+#define BOOST_TEST_MODULE error_handler
+
+#include <stdexcept>
+#include <exception>
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include "core/dictionary.hpp"
+#include "core/option.hpp"
+#include "core/parser.hpp"
+
+#include "error/unrecognized_option.hpp"
+
+#include "generic/error_handler.hpp"
+
+using namespace cli::generic;
+
+namespace
+{
+    std::string handled;
+
+    void record(const std::exception& error)
+    {
+	handled = error.what();
+    }
+}
+
+BOOST_AUTO_TEST_SUITE(installation);
+
+BOOST_AUTO_TEST_CASE(install_and_uninstall_handler)
+{
+    BOOST_TEST(error_handler() == nullptr);
+
+    BOOST_TEST(error_handler(record) == nullptr);
+    BOOST_TEST(error_handler() == record);
+
+    BOOST_TEST(error_handler(nullptr) == record);
+    BOOST_TEST(error_handler() == nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE(raise_errors);
+
+BOOST_AUTO_TEST_CASE(call_handler_before_throwing)
+{
+    error_handler(record);
+
+    handled.clear();
+
+    BOOST_CHECK_THROW(raise(std::out_of_range {"out of range"}),
+		      std::out_of_range);
+
+    BOOST_CHECK_EQUAL(handled, "out of range");
+
+    error_handler(nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(route_parser_errors)
+{
+    using namespace cli::core;
+
+    error_handler(record);
+
+    handled.clear();
+
+    parser parser {dictionary {option {"-h", "--help"}}};
+
+    const char* argv[] = {
+	"",
+	"--unknown",
+	nullptr
+    };
+
+    BOOST_CHECK_THROW(parser.parse_command_line(std::size(argv), argv),
+		      cli::error::unrecognized_option);
+
+    BOOST_CHECK_EQUAL(handled, "unrecognized option --unknown");
+
+    handled.clear();
+
+    BOOST_CHECK_THROW(dictionary {}["--help"], std::out_of_range);
+
+    BOOST_TEST(not handled.empty());
+
+    error_handler(nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
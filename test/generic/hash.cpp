@@ -0,0 +1,57 @@
+#define BOOST_TEST_MODULE hash
+
+#include <cstdint>
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include "generic/hash.hpp"
+
+using namespace cli::generic;
+
+BOOST_AUTO_TEST_SUITE(fnv1a_hash);
+
+BOOST_AUTO_TEST_CASE(hash_bytes)
+{
+    static_assert(fnv1a("--help") == fnv1a("--help"));
+
+    BOOST_CHECK_NE(fnv1a("--help"), fnv1a("--hel"));
+
+    BOOST_CHECK_NE(fnv1a(fnv1a("-h"), ""), fnv1a("-h"));
+
+    BOOST_CHECK_NE(fnv1a(fnv1a("ab"), "c"), fnv1a(fnv1a("a"), "bc"));
+}
+
+BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE(fast_hash_bytes);
+
+BOOST_AUTO_TEST_CASE(hash_bytes)
+{
+    BOOST_CHECK_EQUAL(fast_hash("--help"), fast_hash("--help"));
+
+    BOOST_CHECK_NE(fast_hash("--help"), fast_hash("--hel"));
+    BOOST_CHECK_NE(fast_hash(""), fast_hash(1, ""));
+
+    BOOST_CHECK_NE(fast_hash(fast_hash("ab"), "c"),
+		   fast_hash(fast_hash("a"), "bc"));
+
+    std::string long_key(100, 'x');
+
+    auto hash = fast_hash(long_key);
+
+    long_key[57] = 'y';
+
+    BOOST_CHECK_NE(fast_hash(long_key), hash);
+}
+
+BOOST_AUTO_TEST_CASE(mix_full_product)
+{
+    BOOST_CHECK_EQUAL(multiply_mix(0, 12345), 0);
+    BOOST_CHECK_EQUAL(multiply_mix(2, 3), 6);
+
+    // 2^63 * 4 = 2^65: low half 0, high half 2.
+    BOOST_CHECK_EQUAL(multiply_mix(std::uint64_t {1} << 63, 4), 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
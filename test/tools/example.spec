@@ -0,0 +1,31 @@
+# Options of a small archiver, covering every kind of generated field.
+namespace: example_options
+
+option: create
+    short: -c
+    long: --create
+    description: create a new archive
+
+option: file
+    short: -f
+    long: --file
+    argument: <archive>
+    required: true
+    description: use archive file
+
+option: exclude
+    long: --exclude
+    argument: <pattern>
+    multiple: true
+    description: skip files matching "pattern"
+
+option: level
+    short: -l
+    argument: <number>
+    default: 6
+    description: compression level
+
+option: verbose
+    short: -v
+    long: --verbose
+    description: list processed files
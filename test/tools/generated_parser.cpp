@@ -0,0 +1,253 @@
+#define BOOST_TEST_MODULE generated_parser
+
+#include <initializer_list>
+#include <string_view>
+#include <optional>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "core/diagnostic.hpp"
+#include "core/option_map.hpp"
+#include "core/parser.hpp"
+
+#include "example.hpp"
+
+using namespace cli::core;
+
+namespace
+{
+    std::vector<const char*> command_line(
+	std::initializer_list<const char*> tokens)
+    {
+	std::vector<const char*> argv {""};
+
+	argv.insert(argv.end(), tokens);
+
+	argv.emplace_back(nullptr);
+
+	return argv;
+    }
+
+    std::optional<diagnostic> parse(const std::vector<const char*>& argv,
+				    example_options::settings& settings)
+    {
+	return example_options::parse(argv.size() - 1,
+				      const_cast<const char**>(argv.data()),
+				      settings);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE(generated_parser);
+
+BOOST_AUTO_TEST_CASE(fill_settings)
+{
+    example_options::settings settings;
+
+    auto argv = command_line({
+	"-cv",
+	"-c",
+	"--file",
+	"a.tar",
+	"--exclude=*.o",
+	"src",
+	"--exclude",
+	"*.a",
+	"-l",
+	"9",
+	"-f",
+	"b.tar"
+    });
+
+    // -cv is no option name, so it is kept as a positional option.
+    BOOST_TEST(not parse(argv, settings));
+
+    BOOST_TEST(settings.create);
+    BOOST_TEST(not settings.verbose);
+
+    BOOST_CHECK_EQUAL(settings.file,  "b.tar");
+    BOOST_CHECK_EQUAL(settings.level, "9");
+
+    BOOST_REQUIRE_EQUAL(settings.exclude.size(), 2);
+    BOOST_CHECK_EQUAL(settings.exclude[0], "*.o");
+    BOOST_CHECK_EQUAL(settings.exclude[1], "*.a");
+
+    BOOST_REQUIRE_EQUAL(settings.positional_options.size(), 2);
+    BOOST_CHECK_EQUAL(settings.positional_options[0], "-cv");
+    BOOST_CHECK_EQUAL(settings.positional_options[1], "src");
+
+    argv = command_line({"--file=c.tar"});
+
+    BOOST_TEST(not parse(argv, settings));
+
+    BOOST_TEST(not settings.create);
+    BOOST_TEST(settings.exclude.empty());
+    BOOST_TEST(settings.positional_options.empty());
+
+    BOOST_CHECK_EQUAL(settings.file,  "c.tar");
+    BOOST_CHECK_EQUAL(settings.level, "6");
+}
+
+BOOST_AUTO_TEST_CASE(report_errors)
+{
+    example_options::settings settings;
+
+    auto check = [&](std::initializer_list<const char*> tokens,
+		     diagnostic::kind                    type,
+		     int                                 index,
+		     grammar::size_type                  id)
+    {
+	auto result = parse(command_line(tokens), settings);
+
+	BOOST_REQUIRE(result);
+
+	BOOST_TEST((result->type == type));
+	BOOST_CHECK_EQUAL(result->index, index);
+	BOOST_CHECK_EQUAL(result->id, id);
+    };
+
+    check({"-f", "a", "--unknown"},
+	  diagnostic::kind::unrecognized_option, 3, grammar::npos);
+
+    check({"-f", "a", "-v", "--verbose"},
+	  diagnostic::kind::option_already_added_as, 4, 4);
+
+    check({"-f", "--create"},
+	  diagnostic::kind::option_expects_argument, 1, 1);
+
+    check({"--file="},
+	  diagnostic::kind::option_expects_argument, 1, 1);
+
+    check({"-c"},
+	  diagnostic::kind::option_is_required_but_not_added,
+	  diagnostic::no_index,
+	  1);
+}
+
+// The generated parser reports the first error of every command line
+// exactly like the generic parser over the same options.
+BOOST_AUTO_TEST_CASE(match_generic_parser)
+{
+    const parser parser {example_options::options()};
+
+    example_options::settings settings;
+
+    for (auto&& tokens : {
+	    command_line({"-f", "a"}),
+	    command_line({"-f", "a", "-f", "b", "x", "-c", "-l", "1"}),
+	    command_line({"-f"}),
+	    command_line({"-f", "a", "-l"}),
+	    command_line({"-f", "a", "-c", "--create"}),
+	    command_line({"--exclude", "-f", "a"}),
+	    command_line({"--file=a", "--verbose=", "-v"}),
+	    command_line({"--file=a", "--level"}),
+	    command_line({"-x", "-f", "a"}),
+	    command_line({"x", "--", "y"}),
+	    command_line({})
+	})
+    {
+	auto expected = parser.validate(tokens.size() - 1,
+					 const_cast<const char**>(tokens.data()));
+
+	auto result = parse(tokens, settings);
+
+	BOOST_REQUIRE_EQUAL(result.has_value(), expected.has_value());
+
+	if (result)
+	{
+	    BOOST_TEST((result->type == expected->type));
+	    BOOST_CHECK_EQUAL(result->index, expected->index);
+	    BOOST_CHECK_EQUAL(result->id, expected->id);
+	}
+    }
+}
+
+// Every option reads back from the settings what option_map holds for
+// the same command line: inline arguments split on commas, and repeated
+// options with arguments keep every argument or the last one.
+BOOST_AUTO_TEST_CASE(match_option_map)
+{
+    example_options::settings settings;
+
+    for (auto&& tokens : {
+	    command_line({"-f", "a", "-f", "b"}),
+	    command_line({"--file=a,b", "-c"}),
+	    command_line({"-f", "a,b", "--file=,c,", "-l", "1"}),
+	    command_line({"--file=a", "--exclude=*.o,,*.a", "--exclude", "x,y"}),
+	    command_line({"-f", "a", "--exclude=,", "--exclude=z", "-v"})
+	})
+    {
+	cli::core::parser parser {example_options::options()};
+
+	parser.parse_command_line(tokens.size() - 1,
+				  const_cast<const char**>(tokens.data()));
+
+	option_map map {example_options::options()};
+
+	map.add_command_line_options(parser.options());
+
+	BOOST_REQUIRE(not parse(tokens, settings));
+
+	BOOST_CHECK_EQUAL(settings.create,  map.contains("-c").has_value());
+	BOOST_CHECK_EQUAL(settings.verbose, map.contains("-v").has_value());
+
+	BOOST_CHECK_EQUAL(settings.file, map["-f"].back());
+
+	if (map.contains("-l"))
+	{
+	    BOOST_CHECK_EQUAL(settings.level, map["-l"].back());
+	}
+
+	std::vector<std::string_view> excluded;
+
+	if (map.contains("--exclude"))
+	{
+	    excluded.assign(map["--exclude"].cbegin(), map["--exclude"].cend());
+	}
+
+	BOOST_CHECK_EQUAL_COLLECTIONS(settings.exclude.cbegin(),
+				      settings.exclude.cend(),
+				      excluded.cbegin(),
+				      excluded.cend());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(describe_options)
+{
+    auto& options = example_options::options();
+
+    BOOST_REQUIRE_EQUAL(options.size(), 5);
+
+    auto& exclude = options.begin()[2];
+
+    BOOST_CHECK_EQUAL(exclude.short_name(), "");
+    BOOST_CHECK_EQUAL(exclude.long_name(), "--exclude");
+    BOOST_CHECK_EQUAL(exclude.representation(), "--exclude <pattern>");
+    BOOST_CHECK_EQUAL(exclude.description(),
+		      "skip files matching \"pattern\"");
+
+    BOOST_TEST(exclude.has_arguments());
+    BOOST_TEST(not exclude.is_required());
+
+    BOOST_TEST(options.begin()[1].is_required());
+    BOOST_TEST(not options.begin()[4].has_arguments());
+
+    option_map map {options};
+
+    auto argv = command_line({"-f", "a.tar", "-l", "3"});
+
+    cli::core::parser parser {options};
+
+    parser.parse_command_line(argv.size() - 1, argv.data());
+
+    map.add_command_line_options(parser.options());
+
+    example_options::settings settings;
+
+    BOOST_TEST(not parse(argv, settings));
+
+    BOOST_CHECK_EQUAL(map["--file"].back(), settings.file);
+    BOOST_CHECK_EQUAL(map["-l"].back(), settings.level);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
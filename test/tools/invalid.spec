@@ -0,0 +1,7 @@
+namespace: invalid_options
+
+option: first
+    short: -f
+
+option: second
+    short: -f
@@ -0,0 +1,858 @@
+#include <string_view>
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <optional>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <utility>
+#include <string>
+#include <memory_resource>
+#include <vector>
+
+#include "core/option_map.hpp"
+#include "core/option.hpp"
+#include "core/parser.hpp"
+
+#include "generic/hash.hpp"
+
+// Turns a parser spec into a header with a perfect hash of the option
+// names, a parse function dispatching on the option id with a switch and
+// a settings struct with one field per option.
+//
+// A spec names the namespace of the generated code and lists options;
+// the indented lines below an option describe it:
+//
+//     # comment
+//     namespace: tool_options
+//
+//     option: output
+//         short: -o
+//         long: --output
+//         argument: <file>
+//         required: true
+//         description: write the result to file
+//
+// Options without an argument become bool fields, options with one a
+// std::string_view holding the last argument (or default), and options
+// marked multiple a vector of every argument given. Arguments are read as
+// option_map reads them: one after = is split on commas, and an option
+// with arguments may be repeated, as the generic parser allows.
+
+using namespace cli::core;
+
+namespace
+{
+    struct option_spec final
+    {
+	std::string field;
+	std::string short_name;
+	std::string long_name;
+	std::string argument;
+	std::string description;
+
+	std::optional<std::string> default_argument;
+
+	bool required = false;
+	bool multiple = false;
+
+	std::size_t line = 0;
+    };
+
+    struct parser_spec final
+    {
+	std::string name;
+
+	std::vector<option_spec> options;
+    };
+
+    struct perfect_hash final
+    {
+	std::uint64_t seed  = 0;
+	int           shift = 63;
+
+	// The index of the option each slot belongs to, or -1.
+	std::vector<int> slots;
+    };
+
+    class spec_reader final
+    {
+    public:
+
+	explicit spec_reader(std::string_view path) noexcept :
+	    path {path}
+	{}
+
+	bool read(std::istream& input, parser_spec& spec)
+	{
+	    std::string line;
+
+	    while (std::getline(input, line))
+	    {
+		++line_number;
+
+		auto text = trim(line);
+
+		if (text.empty() || text.starts_with('#'))
+		{
+		    continue;
+		}
+
+		auto colon = text.find(':');
+
+		if (colon == std::string_view::npos)
+		{
+		    return fail("expected key: value");
+		}
+
+		auto key   = trim(text.substr(0, colon));
+		auto value = trim(text.substr(colon + 1));
+
+		bool indented = line.starts_with(' ') || line.starts_with('\t');
+
+		if (not (indented ?
+			 read_option_key(spec, key, value) :
+			 read_key(spec, key, value)))
+		{
+		    return false;
+		}
+	    }
+
+	    return check(spec);
+	}
+
+    private:
+
+	bool read_key(parser_spec& spec, std::string_view key,
+		      std::string_view value)
+	{
+	    if (key == "namespace")
+	    {
+		if (not is_identifier(value))
+		{
+		    return fail("namespace must be an identifier");
+		}
+
+		spec.name = value;
+
+		return true;
+	    }
+
+	    if (key == "option")
+	    {
+		if (not is_identifier(value) || value == "positional_options")
+		{
+		    return fail("option must name a field identifier");
+		}
+
+		auto& option = spec.options.emplace_back();
+
+		option.field = value;
+		option.line  = line_number;
+
+		return true;
+	    }
+
+	    return fail("unknown key " + std::string {key});
+	}
+
+	bool read_option_key(parser_spec& spec, std::string_view key,
+			     std::string_view value)
+	{
+	    if (spec.options.empty())
+	    {
+		return fail("indented key outside of an option");
+	    }
+
+	    auto& option = spec.options.back();
+
+	    if (key == "short")
+	    {
+		if (not is_short_option_name(value))
+		{
+		    return fail("short must be a dash and one character");
+		}
+
+		option.short_name = value;
+	    }
+
+	    else if (key == "long")
+	    {
+		if (not is_long_option_name(value) ||
+		    value.find('=') != std::string_view::npos)
+		{
+		    return fail("long must start with -- and not contain =");
+		}
+
+		option.long_name = value;
+	    }
+
+	    else if (key == "argument")
+	    {
+		option.argument = value.empty() ? "<value>" : value;
+	    }
+
+	    else if (key == "default")
+	    {
+		option.default_argument = value;
+	    }
+
+	    else if (key == "description")
+	    {
+		option.description = value;
+	    }
+
+	    else if (key == "required" || key == "multiple")
+	    {
+		if (value != "true" && value != "false")
+		{
+		    return fail(std::string {key} + " must be true or false");
+		}
+
+		(key == "required" ? option.required : option.multiple) =
+		    value == "true";
+	    }
+
+	    else
+	    {
+		return fail("unknown option key " + std::string {key});
+	    }
+
+	    return true;
+	}
+
+	bool check(const parser_spec& spec)
+	{
+	    if (spec.name.empty())
+	    {
+		line_number = 0;
+
+		return fail("missing namespace");
+	    }
+
+	    std::vector<std::string_view> names;
+	    std::vector<std::string_view> fields;
+
+	    for (auto&& option : spec.options)
+	    {
+		line_number = option.line;
+
+		if (option.short_name.empty() && option.long_name.empty())
+		{
+		    return fail("option needs a short or long name");
+		}
+
+		if (option.argument.empty() &&
+		    (option.multiple || option.default_argument))
+		{
+		    return fail("multiple and default need an argument");
+		}
+
+		if (option.multiple && option.default_argument)
+		{
+		    return fail("multiple options have no default");
+		}
+
+		for (auto name : {std::string_view {option.short_name},
+				  std::string_view {option.long_name}})
+		{
+		    if (name.empty())
+		    {
+			continue;
+		    }
+
+		    if (std::find(names.cbegin(), names.cend(), name) !=
+			names.cend())
+		    {
+			return fail("duplicate option name " + std::string {name});
+		    }
+
+		    names.emplace_back(name);
+		}
+
+		if (std::find(fields.cbegin(), fields.cend(), option.field) !=
+		    fields.cend())
+		{
+		    return fail("duplicate option " + option.field);
+		}
+
+		fields.emplace_back(option.field);
+	    }
+
+	    return true;
+	}
+
+	bool fail(std::string_view message) const
+	{
+	    std::cerr << path;
+
+	    if (line_number != 0)
+	    {
+		std::cerr << ':' << line_number;
+	    }
+
+	    std::cerr << ": " << message << '\n';
+
+	    return false;
+	}
+
+	static std::string_view trim(std::string_view text) noexcept
+	{
+	    auto first = text.find_first_not_of(" \t\r");
+
+	    if (first == std::string_view::npos)
+	    {
+		return {};
+	    }
+
+	    return text.substr(first, text.find_last_not_of(" \t\r") + 1 - first);
+	}
+
+	static bool is_identifier(std::string_view text) noexcept
+	{
+	    auto is_letter = [](char c)
+	    {
+		return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+		    c == '_';
+	    };
+
+	    if (text.empty() || not is_letter(text.front()))
+	    {
+		return false;
+	    }
+
+	    return std::all_of(text.cbegin(), text.cend(), [&](char c)
+	    {
+		return is_letter(c) || (c >= '0' && c <= '9');
+	    });
+	}
+
+	std::string_view path;
+
+	std::size_t line_number = 0;
+    };
+
+    constexpr std::uint64_t mix = 0x9e3779b97f4a7c15;
+
+    // fnv1a alone barely carries a difference in the last byte of a short
+    // name into its high bits, whatever the seed; multiply_mix spreads it.
+    std::size_t slot_of(const perfect_hash& hash, std::string_view name)
+    {
+	return cli::generic::multiply_mix(
+	    cli::generic::fnv1a(hash.seed, name), mix) >> hash.shift;
+    }
+
+    // Grows the table when no seed separates the names.
+    perfect_hash find_perfect_hash(const parser_spec& spec)
+    {
+	std::vector<std::pair<std::string_view, int>> names;
+
+	for (int id = 0; auto&& option : spec.options)
+	{
+	    for (auto name : {std::string_view {option.short_name},
+			      std::string_view {option.long_name}})
+	    {
+		if (not name.empty())
+		{
+		    names.emplace_back(name, id);
+		}
+	    }
+
+	    ++id;
+	}
+
+	int bits = 1;
+
+	while ((std::size_t {1} << bits) < names.size() * 2)
+	{
+	    ++bits;
+	}
+
+	perfect_hash hash;
+
+	for (;; ++bits)
+	{
+	    hash.shift = 64 - bits;
+
+	    for (hash.seed = 0; hash.seed < 100'000; ++hash.seed)
+	    {
+		hash.slots.assign(std::size_t {1} << bits, -1);
+
+		auto collides = std::any_of(
+		    names.cbegin(),
+		    names.cend(),
+		    [&](auto&& name)
+		    {
+			auto& slot = hash.slots[slot_of(hash, name.first)];
+
+			return std::exchange(slot, name.second) != -1;
+		    });
+
+		if (not collides)
+		{
+		    return hash;
+		}
+	    }
+	}
+    }
+
+    std::string quote(std::string_view text)
+    {
+	std::string quoted {'"'};
+
+	for (char c : text)
+	{
+	    if (c == '"' || c == '\\')
+	    {
+		quoted += '\\';
+	    }
+
+	    quoted += c;
+	}
+
+	return quoted += '"';
+    }
+
+    std::string representation(const option_spec& option)
+    {
+	std::string representation = option.short_name;
+
+	if (not option.long_name.empty())
+	{
+	    if (not representation.empty())
+	    {
+		representation += ", ";
+	    }
+
+	    representation += option.long_name;
+	}
+
+	if (not option.argument.empty())
+	{
+	    representation += ' ' + option.argument;
+	}
+
+	return representation;
+    }
+
+    // The names of an option's slots, as they appear on the command line.
+    std::string slot_name(const parser_spec& spec,
+			  const perfect_hash& hash,
+			  std::size_t slot)
+    {
+	auto& option = spec.options[hash.slots[slot]];
+
+	bool is_short = not option.short_name.empty() &&
+	    slot_of(hash, option.short_name) == slot;
+
+	return is_short ? option.short_name : option.long_name;
+    }
+
+    void write_settings(std::ostream& output, const parser_spec& spec)
+    {
+	output <<
+	    "    struct settings final\n"
+	    "    {\n";
+
+	for (auto&& option : spec.options)
+	{
+	    output << '\t';
+
+	    if (option.argument.empty())
+	    {
+		output << "bool " << option.field << " = false;\n\n";
+	    }
+
+	    else if (option.multiple)
+	    {
+		output << "std::vector<std::string_view> " << option.field
+		       << ";\n\n";
+	    }
+
+	    else
+	    {
+		output << "std::string_view " << option.field;
+
+		if (option.default_argument)
+		{
+		    output << " = " << quote(*option.default_argument);
+		}
+
+		output << ";\n\n";
+	    }
+	}
+
+	output <<
+	    "\tstd::vector<std::string_view> positional_options;\n"
+	    "    };\n\n";
+    }
+
+    void write_options(std::ostream& output, const parser_spec& spec)
+    {
+	output <<
+	    "    // The options of the spec as a dictionary, for help output and\n"
+	    "    // the generic parser; diagnostic ids are indexes into it.\n"
+	    "    inline const cli::core::dictionary& options()\n"
+	    "    {\n"
+	    "\tusing cli::core::option;\n\n"
+	    "\tstatic const cli::core::dictionary options {\n";
+
+	for (std::size_t i = 0; i < spec.options.size(); ++i)
+	{
+	    auto& option = spec.options[i];
+
+	    output <<
+		"\t    option {\n"
+		"\t\t" << quote(option.short_name) << ",\n"
+		"\t\t" << quote(option.long_name) << ",\n"
+		"\t\t" << quote(representation(option)) << ",\n"
+		"\t\t" << quote(option.description) << ",\n"
+		"\t\toption::required::" <<
+		(option.required ? "required" : "not_required") << ",\n"
+		"\t\toption::arguments::" <<
+		(option.argument.empty() ? "no_arguments" : "has_arguments") <<
+		"\n"
+		"\t    }" << (i + 1 < spec.options.size() ? "," : "") << '\n';
+	}
+
+	output <<
+	    "\t};\n\n"
+	    "\treturn options;\n"
+	    "    }\n\n";
+    }
+
+    void write_lookup(std::ostream& output,
+		      const parser_spec& spec,
+		      const perfect_hash& hash)
+    {
+	output <<
+	    "    namespace detail\n"
+	    "    {\n"
+	    "\tstruct slot final\n"
+	    "\t{\n"
+	    "\t    std::string_view name;\n"
+	    "\t    int              id = -1;\n"
+	    "\t};\n\n"
+	    "\tinline constexpr std::uint64_t seed  = " << hash.seed << ";\n"
+	    "\tinline constexpr std::uint64_t mix   = 0x" << std::hex << mix << std::dec << ";\n"
+	    "\tinline constexpr int           shift = " << hash.shift << ";\n\n"
+	    "\tinline constexpr slot slots[" << hash.slots.size() << "] = {\n";
+
+	for (std::size_t i = 0; i < hash.slots.size(); ++i)
+	{
+	    output << "\t    ";
+
+	    if (hash.slots[i] == -1)
+	    {
+		output << "{}";
+	    }
+
+	    else
+	    {
+		output << '{' << quote(slot_name(spec, hash, i)) << ", "
+		       << hash.slots[i] << '}';
+	    }
+
+	    output << (i + 1 < hash.slots.size() ? ",\n" : "\n");
+	}
+
+	output <<
+	    "\t};\n\n"
+	    "\t// The id of the option named name, or -1.\n"
+	    "\tinline int find(std::string_view name) noexcept\n"
+	    "\t{\n"
+	    "\t    auto hash = cli::generic::fnv1a(seed, name);\n\n"
+	    "\t    auto& slot = slots[cli::generic::multiply_mix(hash, mix) >> shift];\n\n"
+	    "\t    return slot.name == name ? slot.id : -1;\n"
+	    "\t}\n\n"
+	    "\tinline bool next_argument(int               argc,\n"
+	    "\t\t\t\t  const char**      argv,\n"
+	    "\t\t\t\t  int&              index,\n"
+	    "\t\t\t\t  std::string_view& argument) noexcept\n"
+	    "\t{\n"
+	    "\t    if (index + 1 < argc && argv[index + 1] &&\n"
+	    "\t\tnot cli::core::is_option_name(std::string_view {argv[index + 1]}))\n"
+	    "\t    {\n"
+	    "\t\targument = argv[++index];\n\n"
+	    "\t\treturn true;\n"
+	    "\t    }\n\n"
+	    "\t    return false;\n"
+	    "\t}\n\n"
+	    "\t// Calls function with every argument as option_map stores it:\n"
+	    "\t// an argument after = is split on commas.\n"
+	    "\ttemplate<typename Function>\n"
+	    "\tinline void for_each_argument(std::string_view argument,\n"
+	    "\t\t\t\t      bool             inline_argument,\n"
+	    "\t\t\t\t      Function&&       function)\n"
+	    "\t{\n"
+	    "\t    if (not inline_argument)\n"
+	    "\t    {\n"
+	    "\t\tfunction(argument);\n\n"
+	    "\t\treturn;\n"
+	    "\t    }\n\n"
+	    "\t    for (std::size_t first = 0; first < argument.size();)\n"
+	    "\t    {\n"
+	    "\t\tauto last = std::min(argument.find(',', first), argument.size());\n\n"
+	    "\t\tif (first < last)\n"
+	    "\t\t{\n"
+	    "\t\t    function(argument.substr(first, last - first));\n"
+	    "\t\t}\n\n"
+	    "\t\tfirst = last + 1;\n"
+	    "\t    }\n"
+	    "\t}\n"
+	    "    }\n\n";
+    }
+
+    void write_parse(std::ostream& output, const parser_spec& spec)
+    {
+	auto words = spec.options.empty() ? 1 : (spec.options.size() + 63) / 64;
+
+	output <<
+	    "    // Parses argv[1] onwards into settings, reusing the capacity of\n"
+	    "    // its vectors. Reports the first error as parser::validate does.\n"
+	    "    inline std::optional<cli::core::diagnostic>\n"
+	    "    parse(int argc, const char** argv, settings& settings)\n"
+	    "    {\n"
+	    "\tusing cli::core::diagnostic;\n"
+	    "\tusing cli::core::grammar;\n\n";
+
+	for (auto&& option : spec.options)
+	{
+	    output << "\tsettings." << option.field;
+
+	    if (option.argument.empty())
+	    {
+		output << " = false;\n";
+	    }
+
+	    else if (option.multiple)
+	    {
+		output << ".clear();\n";
+	    }
+
+	    else
+	    {
+		output << " = "
+		       << (option.default_argument ?
+			   quote(*option.default_argument) :
+			   std::string {"{}"})
+		       << ";\n";
+	    }
+	}
+
+	output <<
+	    "\tsettings.positional_options.clear();\n\n"
+	    "\tstd::uint64_t presence[" << words << "] = {};\n\n"
+	    "\tfor (int index = 1; index < argc && argv[index]; ++index)\n"
+	    "\t{\n"
+	    "\t    std::string_view token = argv[index];\n\n"
+	    "\t    if (not cli::core::is_option_name(token))\n"
+	    "\t    {\n"
+	    "\t\tsettings.positional_options.emplace_back(token);\n\n"
+	    "\t\tcontinue;\n"
+	    "\t    }\n\n"
+	    "\t    auto option_name = token.substr(0, token.find('='));\n\n"
+	    "\t    int id = detail::find(option_name);\n\n"
+	    "\t    if (id < 0)\n"
+	    "\t    {\n"
+	    "\t\treturn diagnostic {\n"
+	    "\t\t    diagnostic::kind::unrecognized_option, index, grammar::npos\n"
+	    "\t\t};\n"
+	    "\t    }\n\n"
+	    "\t    bool inline_argument = option_name.size() < token.size();\n\n"
+	    "\t    [[maybe_unused]] auto argument =\n"
+	    "\t\ttoken.substr(option_name.size() + inline_argument);\n\n"
+	    "\t    if (inline_argument && argument.empty())\n"
+	    "\t    {\n"
+	    "\t\treturn diagnostic {\n"
+	    "\t\t    diagnostic::kind::option_expects_argument,\n"
+	    "\t\t    index,\n"
+	    "\t\t    static_cast<grammar::size_type>(id)\n"
+	    "\t\t};\n"
+	    "\t    }\n\n"
+	    "\t    auto& word = presence[id / 64];\n"
+	    "\t    auto  bit  = std::uint64_t {1} << (id % 64);\n\n"
+	    "\t    switch (id)\n"
+	    "\t    {\n";
+
+	for (std::size_t id = 0; id < spec.options.size(); ++id)
+	{
+	    auto& option = spec.options[id];
+
+	    output <<
+		"\t    case " << id << ": // " << representation(option) << "\n";
+
+	    if (option.argument.empty())
+	    {
+		output <<
+		    "\t\tif (word & bit)\n"
+		    "\t\t{\n"
+		    "\t\t    return diagnostic {\n"
+		    "\t\t\tdiagnostic::kind::option_already_added_as, index, " <<
+		    id << "\n"
+		    "\t\t    };\n"
+		    "\t\t}\n\n"
+		    "\t\tsettings." << option.field << " = true;\n";
+	    }
+
+	    else
+	    {
+		output <<
+		    "\t\tif (not (inline_argument ||\n"
+		    "\t\t\t detail::next_argument(argc, argv, index, argument)))\n"
+		    "\t\t{\n"
+		    "\t\t    return diagnostic {\n"
+		    "\t\t\tdiagnostic::kind::option_expects_argument, index, " <<
+		    id << "\n"
+		    "\t\t    };\n"
+		    "\t\t}\n\n"
+		    "\t\tdetail::for_each_argument(\n"
+		    "\t\t    argument, inline_argument, [&](std::string_view value)\n"
+		    "\t\t    {\n"
+		    "\t\t\tsettings." << option.field <<
+		    (option.multiple ? ".emplace_back(value);\n" : " = value;\n") <<
+		    "\t\t    });\n";
+	    }
+
+	    output << "\t\tbreak;\n\n";
+	}
+
+	output <<
+	    "\t    default:\n"
+	    "\t\tbreak;\n"
+	    "\t    }\n\n"
+	    "\t    word |= bit;\n"
+	    "\t}\n\n";
+
+	for (std::size_t id = 0; id < spec.options.size(); ++id)
+	{
+	    if (spec.options[id].required)
+	    {
+		output <<
+		    "\tif (not (presence[" << id / 64 << "] & (std::uint64_t {1} << "
+		    << id % 64 << ")))\n"
+		    "\t{\n"
+		    "\t    return diagnostic {\n"
+		    "\t\tdiagnostic::kind::option_is_required_but_not_added,\n"
+		    "\t\tdiagnostic::no_index,\n"
+		    "\t\t" << id << "\n"
+		    "\t    };\n"
+		    "\t}\n\n";
+	    }
+	}
+
+	output <<
+	    "\treturn {};\n"
+	    "    }\n\n"
+	    "    inline std::optional<cli::core::diagnostic>\n"
+	    "    parse(int argc, char** argv, settings& settings)\n"
+	    "    {\n"
+	    "\treturn parse(argc, const_cast<const char**>(argv), settings);\n"
+	    "    }\n";
+    }
+
+    std::string generate(std::string_view spec_path, const parser_spec& spec)
+    {
+	std::ostringstream output;
+
+	auto file_name = spec_path.substr(spec_path.find_last_of('/') + 1);
+
+	output <<
+	    "// Generated by cli_generate from " << file_name << "; do not edit.\n\n"
+	    "#pragma once\n\n"
+	    "#include <string_view>\n"
+	    "#include <algorithm>\n"
+	    "#include <optional>\n"
+	    "#include <cstddef>\n"
+	    "#include <cstdint>\n"
+	    "#include <vector>\n\n"
+	    "#include \"core/diagnostic.hpp\"\n"
+	    "#include \"core/dictionary.hpp\"\n"
+	    "#include \"core/grammar.hpp\"\n"
+	    "#include \"core/option.hpp\"\n\n"
+	    "#include \"generic/hash.hpp\"\n\n"
+	    "namespace " << spec.name << "\n"
+	    "{\n";
+
+	write_settings(output, spec);
+	write_options(output, spec);
+	write_lookup(output, spec, find_perfect_hash(spec));
+	write_parse(output, spec);
+
+	output << "}\n";
+
+	return std::move(output).str();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const option output {
+	"-o",
+	"--output",
+	"-o, --output <header>",
+	"write the generated parser to header",
+	option::required::required,
+	option::arguments::has_arguments
+    };
+
+    const dictionary options {output};
+
+    basic_parser<
+	automatic_lookup,
+	vector_storage,
+	expect_errors,
+	std::pmr::polymorphic_allocator<>
+    > parser {options};
+
+    if (not parser.parse_command_line(argc, argv) ||
+	parser.positional_options().size() != 1)
+    {
+	if (auto error = parser.errors().error())
+	{
+	    std::cerr << "cli_generate: " << error->what() << '\n';
+	}
+
+	std::cerr << "usage: cli_generate --output <header> <spec>\n";
+
+	return EXIT_FAILURE;
+    }
+
+    option_map map {options};
+
+    map.add_command_line_options(parser.options());
+
+    std::string spec_path {parser.positional_options().front()};
+    std::string header_path {map[output].back()};
+
+    std::ifstream input {spec_path};
+
+    if (not input)
+    {
+	std::cerr << spec_path << ": cannot open spec\n";
+
+	return EXIT_FAILURE;
+    }
+
+    parser_spec spec;
+
+    if (not spec_reader {spec_path}.read(input, spec))
+    {
+	return EXIT_FAILURE;
+    }
+
+    auto header = generate(spec_path, spec);
+
+    std::ofstream file {header_path, std::ios::binary | std::ios::trunc};
+
+    if (not (file << header && file.flush()))
+    {
+	std::cerr << header_path << ": cannot write header\n";
+
+	return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}